@@ -112,7 +112,7 @@ public:
 	virtual void generate(emulated_time output_start, emulated_time output_step, int32_t *buffer) = 0;
 
 	// write data to the ADPCM-A buffer
-	void write_data(ymfm::access_class type, uint32_t base, uint32_t length, uint8_t const *src)
+	virtual void write_data(ymfm::access_class type, uint32_t base, uint32_t length, uint8_t const *src)
 	{
 		uint32_t end = base + length;
 		if (end > m_data[type].size())
@@ -124,6 +124,12 @@ public:
 	void seek_pcm(uint32_t pos) { m_pcm_offset = pos; }
 	uint8_t read_pcm() { auto &pcm = m_data[ymfm::ACCESS_PCM]; return (m_pcm_offset < pcm.size()) ? pcm[m_pcm_offset++] : 0; }
 
+	// stream bytes of PCM data straight to the DAC at the given frequency on
+	// behalf of VGM stream id; only supported by chips with a DAC
+	virtual void start_pcm_stream(uint8_t id, uint32_t start, uint32_t length, uint32_t frequency, bool loop) { }
+	virtual void set_pcm_stream_frequency(uint8_t id, uint32_t frequency) { }
+	virtual void stop_pcm_stream(uint8_t id) { }
+
 protected:
 	// internal state
 	chip_type m_type;
@@ -188,6 +194,13 @@ public:
 		m_queue.push_back(std::make_pair(reg, data));
 	}
 
+	// write data to the given buffer and map it directly into the chip
+	virtual void write_data(ymfm::access_class type, uint32_t base, uint32_t length, uint8_t const *src) override
+	{
+		vgm_chip_base::write_data(type, base, length, src);
+		ymfm_map_external(type, m_data[type].data(), m_data[type].size());
+	}
+
 	// generate one output sample of output
 	virtual void generate(emulated_time output_start, emulated_time output_step, int32_t *buffer) override
 	{
@@ -310,6 +323,83 @@ protected:
 };
 
 
+// ======================> vgm_dac_chip
+
+// extension of vgm_chip for chips that can stream the PCM data to their
+// DAC themselves, consuming it at their own sample rate; the chip has a
+// single DAC, so the most recently started stream owns it and requests
+// from any other stream are ignored
+template<typename ChipType>
+class vgm_dac_chip : public vgm_chip<ChipType>
+{
+public:
+	using vgm_chip<ChipType>::vgm_chip;
+
+	// write data, keeping any stream in progress pointed at the PCM data if
+	// it moves as the buffer grows
+	virtual void write_data(ymfm::access_class type, uint32_t base, uint32_t length, uint8_t const *src) override
+	{
+		vgm_chip<ChipType>::write_data(type, base, length, src);
+		if (type == ymfm::ACCESS_PCM && this->m_chip.dac_stream_active())
+			this->m_chip.set_dac_stream_data(&this->m_data[type][m_stream_start]);
+	}
+
+	// start a stream, clamped to the PCM data present
+	virtual void start_pcm_stream(uint8_t id, uint32_t start, uint32_t length, uint32_t frequency, bool loop) override
+	{
+		auto &pcm = this->m_data[ymfm::ACCESS_PCM];
+		if (start >= pcm.size())
+		{
+			stop_pcm_stream(m_stream_id);
+			return;
+		}
+		length = std::min<uint32_t>(length, pcm.size() - start);
+		uint32_t step = (uint64_t(frequency) << 16) / this->sample_rate();
+		this->m_chip.start_dac_stream(&pcm[start], length, step, loop);
+		m_stream_start = start;
+		m_stream_id = id;
+	}
+
+	// retune the stream in progress, if it belongs to this stream id
+	virtual void set_pcm_stream_frequency(uint8_t id, uint32_t frequency) override
+	{
+		if (id == m_stream_id)
+			this->m_chip.set_dac_stream_step((uint64_t(frequency) << 16) / this->sample_rate());
+	}
+
+	// stop the stream in progress, if it belongs to this stream id
+	virtual void stop_pcm_stream(uint8_t id) override
+	{
+		if (id == m_stream_id)
+		{
+			this->m_chip.stop_dac_stream();
+			m_stream_id = -1;
+		}
+	}
+
+private:
+	// internal state
+	uint32_t m_stream_start = 0;     // offset of the stream in the PCM data
+	int32_t m_stream_id = -1;        // VGM stream owning the DAC, or -1 if none
+};
+
+
+// ======================> vgm_stream
+
+// state of one DAC stream control, as configured by commands 90-95
+struct vgm_stream
+{
+	uint8_t id = 0;                  // stream control id
+	vgm_chip_base *chip = nullptr;   // target chip, or nullptr if unsupported
+	uint8_t bank = 0;                // data bank type
+	uint8_t step_size = 1;           // bytes per write
+	uint8_t step_base = 0;           // offset of the first byte
+	uint32_t frequency = 0;          // writes per second
+	uint32_t start = 0;              // start offset of the last stream
+	uint32_t length = 0;             // length of the last stream
+};
+
+
 
 //*********************************************************
 //  GLOBAL HELPERS
@@ -338,7 +428,7 @@ uint32_t parse_uint32(std::vector<uint8_t> &buffer, uint32_t &offset)
 //  supported chip type
 //-------------------------------------------------
 
-template<typename ChipType>
+template<typename ChipType, typename VgmChipType = vgm_chip<ChipType>>
 void add_chips(uint32_t clock, chip_type type, char const *chipname)
 {
 	uint32_t clockval = clock & 0x3fffffff;
@@ -348,7 +438,7 @@ void add_chips(uint32_t clock, chip_type type, char const *chipname)
 	{
 		char name[100];
 		sprintf(name, "%s #%d", chipname, index);
-		active_chips.push_back(std::make_unique<vgm_chip<ChipType>>(clockval, type, (numchips == 2) ? name : chipname));
+		active_chips.push_back(std::make_unique<VgmChipType>(clockval, type, (numchips == 2) ? name : chipname));
 	}
 
 	if (type == CHIP_YM2608)
@@ -428,7 +518,7 @@ uint32_t parse_header(std::vector<uint8_t> &buffer)
 	// +2C: YM2612 clock
 	clock = parse_uint32(buffer, offset);
 	if (version >= 0x110 && clock != 0)
-		add_chips<ymfm::ym2612>(clock, CHIP_YM2612, "YM2612");
+		add_chips<ymfm::ym2612, vgm_dac_chip<ymfm::ym2612>>(clock, CHIP_YM2612, "YM2612");
 
 	// +30: YM2151 clock
 	clock = parse_uint32(buffer, offset);
@@ -784,6 +874,26 @@ void add_rom_data(chip_type type, ymfm::access_class access, std::vector<uint8_t
 }
 
 
+//-------------------------------------------------
+//  start_stream - start a DAC stream on the
+//  stream's target chip
+//-------------------------------------------------
+
+void start_stream(vgm_stream &stream, uint32_t start, uint32_t length, bool loop)
+{
+	stream.start = start;
+	stream.length = length;
+	if (stream.chip == nullptr)
+		return;
+	if (stream.bank != 0x00 || stream.step_size > 1)
+	{
+		printf("93: Unsupported stream data bank %02X step %d\n", stream.bank, stream.step_size);
+		return;
+	}
+	stream.chip->start_pcm_stream(stream.id, start + stream.step_base, length, stream.frequency, loop);
+}
+
+
 //-------------------------------------------------
 //  generate_all - generate everything described
 //  in the vgmplay file
@@ -796,6 +906,11 @@ void generate_all(std::vector<uint8_t> &buffer, uint32_t data_start, uint32_t ou
 	bool done = false;
 	emulated_time output_step = 0x100000000ull / output_rate;
 	emulated_time output_pos = 0;
+	vgm_stream streams[256];
+	for (int index = 0; index < 256; index++)
+		streams[index].id = index;
+	std::vector<std::pair<uint32_t, uint32_t>> pcm_blocks;
+	uint32_t pcm_bank_size = 0;
 	while (!done && offset < buffer.size())
 	{
 		int delay = 0;
@@ -944,9 +1059,16 @@ void generate_all(std::vector<uint8_t> &buffer, uint32_t data_start, uint32_t ou
 
 					case 0x00: // YM2612 PCM data for use with associated commands
 					{
-						vgm_chip_base *chip = find_chip(CHIP_YM2612, 0);
-						if (chip != nullptr)
-							chip->write_data(ymfm::ACCESS_PCM, 0, size - 8, &buffer[localoffset]);
+						// blocks of this type are appended to one another; remember
+						// where each one lands for the stream control commands
+						pcm_blocks.push_back(std::make_pair(pcm_bank_size, size));
+						for (int index = 0; index < 2; index++)
+						{
+							vgm_chip_base *chip = find_chip(CHIP_YM2612, index);
+							if (chip != nullptr)
+								chip->write_data(ymfm::ACCESS_PCM, pcm_bank_size, size, &buffer[localoffset]);
+						}
+						pcm_bank_size += size;
 						break;
 					}
 
@@ -1037,6 +1159,101 @@ void generate_all(std::vector<uint8_t> &buffer, uint32_t data_start, uint32_t ou
 				break;
 			}
 
+			// ss tt pp cc: setup stream control ss to write to register cc on port pp of chip type tt
+			case 0x90:
+			{
+				vgm_stream &stream = streams[buffer[offset]];
+				uint8_t type = buffer[offset + 1];
+
+				// retargeting a stream stops whatever it was playing on the old chip
+				if (stream.chip != nullptr)
+					stream.chip->stop_pcm_stream(stream.id);
+				stream.chip = nullptr;
+				if ((type & 0x7f) == 0x02 && buffer[offset + 2] == 0x00 && buffer[offset + 3] == 0x2a)
+					stream.chip = find_chip(CHIP_YM2612, type >> 7);
+				else
+					printf("90: Unsupported stream target %02X:%02X:%02X\n", type, buffer[offset + 2], buffer[offset + 3]);
+				offset += 4;
+				break;
+			}
+
+			// ss dd ll bb: set stream ss to read from data bank dd, with step size ll and step base bb
+			case 0x91:
+			{
+				vgm_stream &stream = streams[buffer[offset]];
+				stream.bank = buffer[offset + 1];
+				stream.step_size = buffer[offset + 2];
+				stream.step_base = buffer[offset + 3];
+				offset += 4;
+				break;
+			}
+
+			// ss ffffffff: set stream ss frequency to ffffffff
+			case 0x92:
+			{
+				vgm_stream &stream = streams[buffer[offset++]];
+				stream.frequency = parse_uint32(buffer, offset);
+
+				// drivers can retune a stream while it plays
+				if (stream.chip != nullptr)
+					stream.chip->set_pcm_stream_frequency(stream.id, stream.frequency);
+				break;
+			}
+
+			// ss aaaaaaaa mm llllllll: start stream ss at offset aaaaaaaa, with length llllllll in mode mm
+			case 0x93:
+			{
+				vgm_stream &stream = streams[buffer[offset++]];
+				uint32_t start = parse_uint32(buffer, offset);
+				uint8_t mode = buffer[offset++];
+				uint32_t length = parse_uint32(buffer, offset);
+				if (start == 0xffffffff)
+					start = stream.start;
+
+				// the reverse flag (bit 4) is not supported
+				switch (mode & 0x0f)
+				{
+					// keep the previous length
+					case 0:
+						length = stream.length;
+						break;
+
+					// length in milliseconds
+					case 2:
+						length = uint64_t(length) * stream.frequency / 1000;
+						break;
+
+					// play until the end of the data
+					case 3:
+						length = (start < pcm_bank_size) ? (pcm_bank_size - start) : 0;
+						break;
+				}
+				start_stream(stream, start, length, (mode & 0x80) != 0);
+				break;
+			}
+
+			// ss: stop stream ss, or all streams if ss is FF
+			case 0x94:
+			{
+				uint8_t index = buffer[offset++];
+				for (int stream = 0; stream < 256; stream++)
+					if ((index == 0xff || index == stream) && streams[stream].chip != nullptr)
+						streams[stream].chip->stop_pcm_stream(stream);
+				break;
+			}
+
+			// ss bbbb ff: start stream ss playing data block bbbb, looping if bit 0 of ff is set
+			case 0x95:
+			{
+				vgm_stream &stream = streams[buffer[offset]];
+				uint32_t block = buffer[offset + 1] | (buffer[offset + 2] << 8);
+				uint8_t flags = buffer[offset + 3];
+				if (block < pcm_blocks.size())
+					start_stream(stream, pcm_blocks[block].first, pcm_blocks[block].second, (flags & 0x01) != 0);
+				offset += 4;
+				break;
+			}
+
 			// ignored, consume one byte
 			case 0x30:	case 0x31:	case 0x32:	case 0x33:	case 0x34:	case 0x35:	case 0x36:	case 0x37:
 			case 0x38:	case 0x39:	case 0x3a:	case 0x3b:	case 0x3c:	case 0x3d:	case 0x3e:	case 0x3f:
@@ -42,7 +42,9 @@
 #include <cstdio>
 #include <algorithm>
 #include <memory>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ymfm
@@ -325,6 +327,50 @@ struct ymfm_output
 };
 
 
+// ======================> ymfm_inline_array
+
+// a fixed-size array of objects stored inline in the owning object, for
+// classes that need constructor arguments; each element must be constructed
+// exactly once via construct() before use, and all are destroyed together
+template<typename ObjectType, int Count>
+class ymfm_inline_array
+{
+public:
+	// construction/destruction
+	ymfm_inline_array() { }
+	~ymfm_inline_array()
+	{
+		for (auto &object : *this)
+			object.~ObjectType();
+	}
+
+	// construct the object at the given index in place
+	template<typename... Args>
+	void construct(uint32_t index, Args &&... args)
+	{
+		new (m_storage[index]) ObjectType(std::forward<Args>(args)...);
+	}
+
+	// element access
+	ObjectType &operator[](uint32_t index) { return *reinterpret_cast<ObjectType *>(m_storage[index]); }
+	ObjectType const &operator[](uint32_t index) const { return *reinterpret_cast<ObjectType const *>(m_storage[index]); }
+
+	// iteration
+	ObjectType *begin() { return &(*this)[0]; }
+	ObjectType *end() { return &(*this)[0] + Count; }
+	ObjectType const *begin() const { return &(*this)[0]; }
+	ObjectType const *end() const { return &(*this)[0] + Count; }
+
+private:
+	// no copying
+	ymfm_inline_array(ymfm_inline_array const &) = delete;
+	ymfm_inline_array &operator=(ymfm_inline_array const &) = delete;
+
+	// raw storage for the objects
+	alignas(ObjectType) uint8_t m_storage[Count][sizeof(ObjectType)];
+};
+
+
 // ======================> ymfm_wavfile
 
 // this class is a debugging helper that accumulates data and writes it to wav files
@@ -503,6 +549,14 @@ class ymfm_interface
 	template<typename RegisterType> friend class fm_engine_base;
 
 public:
+	// construction
+	ymfm_interface() :
+		m_engine(nullptr),
+		m_external_base{ nullptr },
+		m_external_length{ 0 }
+	{
+	}
+
 	// the following functions must be implemented by any derived classes; the
 	// default implementations are sufficient for some minimal operation, but will
 	// likely need to be overridden to integrate with the outside world; they are
@@ -559,10 +613,39 @@ public:
 	// of the chip; our responsibility is to pass the written data on to any consumers
 	virtual void ymfm_external_write(access_class type, uint32_t address, uint8_t data) { }
 
+	//
+	// direct memory mapping
+	//
+
+	// hosts whose external memory is a plain buffer can call this to map it
+	// directly; reads below the given length are then served from the buffer
+	// without going through ymfm_external_read(); the buffer must remain valid
+	// (and reflect any ymfm_external_write() calls) until it is remapped, and
+	// passing a length of 0 removes the mapping
+	void ymfm_map_external(access_class type, uint8_t const *base, uint32_t length)
+	{
+		m_external_base[type] = base;
+		m_external_length[type] = (base != nullptr) ? length : 0;
+	}
+
+	// the chip implementation calls this to read from external memory; reads
+	// from a mapped region are handled inline, all others are passed on to
+	// ymfm_external_read()
+	uint8_t ymfm_external_read_mapped(access_class type, uint32_t address)
+	{
+		if (address < m_external_length[type])
+			return m_external_base[type][address];
+		return ymfm_external_read(type, address);
+	}
+
 protected:
 	// pointer to engine callbacks -- this is set directly by the engine at
 	// construction time
 	ymfm_engine_callbacks *m_engine;
+
+	// directly mapped external memory, per access class
+	uint8_t const *m_external_base[ACCESS_CLASSES];
+	uint32_t m_external_length[ACCESS_CLASSES];
 };
 
 }
@@ -176,7 +176,7 @@ bool adpcm_a_channel::clock()
 			return true;
 		}
 
-		m_curbyte = m_owner.intf().ymfm_external_read(ACCESS_ADPCM_A, m_curaddress++);
+		m_curbyte = m_owner.intf().ymfm_external_read_mapped(ACCESS_ADPCM_A, m_curaddress++);
 		data = m_curbyte >> 4;
 		m_curnibble = 1;
 	}
@@ -260,7 +260,7 @@ adpcm_a_engine::adpcm_a_engine(ymfm_interface &intf, uint32_t addrshift) :
 {
 	// create the channels
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum] = std::make_unique<adpcm_a_channel>(*this, chnum, addrshift);
+		m_channel.construct(chnum, *this, chnum, addrshift);
 }
 
 
@@ -275,7 +275,7 @@ void adpcm_a_engine::reset()
 
 	// reset each channel
 	for (auto &chan : m_channel)
-		chan->reset();
+		chan.reset();
 }
 
 
@@ -290,7 +290,7 @@ void adpcm_a_engine::save_restore(ymfm_saved_state &state)
 
 	// save channel state
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum]->save_restore(state);
+		m_channel[chnum].save_restore(state);
 }
 
 
@@ -304,7 +304,7 @@ uint32_t adpcm_a_engine::clock(uint32_t chanmask)
 	uint32_t result = 0;
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			if (m_channel[chnum]->clock())
+			if (m_channel[chnum].clock())
 				result |= 1 << chnum;
 
 	// return the bitmask of completed samples
@@ -325,7 +325,7 @@ void adpcm_a_engine::output(ymfm_output<NumOutputs> &output, uint32_t chanmask)
 	// compute the output of each channel
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			m_channel[chnum]->output(output);
+			m_channel[chnum].output(output);
 }
 
 template void adpcm_a_engine::output<1>(ymfm_output<1> &output, uint32_t chanmask);
@@ -346,7 +346,7 @@ void adpcm_a_engine::write(uint32_t regnum, uint8_t data)
 	if (regnum == 0x00)
 		for (int chnum = 0; chnum < CHANNELS; chnum++)
 			if (bitfield(data, chnum))
-				m_channel[chnum]->keyonoff(bitfield(~data, 7));
+				m_channel[chnum].keyonoff(bitfield(~data, 7));
 }
 
 
@@ -464,7 +464,7 @@ void adpcm_b_channel::clock()
 	{
 		// playing from RAM/ROM
 		if (m_regs.external())
-			m_curbyte = m_owner.intf().ymfm_external_read(ACCESS_ADPCM_B, m_curaddress);
+			m_curbyte = m_owner.intf().ymfm_external_read_mapped(ACCESS_ADPCM_B, m_curaddress);
 	}
 
 	// extract the nibble from our current byte
@@ -580,7 +580,7 @@ uint8_t adpcm_b_channel::read(uint32_t regnum)
 		else
 		{
 			// read from outside of the chip
-			result = m_owner.intf().ymfm_external_read(ACCESS_ADPCM_B, m_curaddress++);
+			result = m_owner.intf().ymfm_external_read_mapped(ACCESS_ADPCM_B, m_curaddress++);
 
 			// did we hit the end? if so, signal EOS
 			if (at_end())
@@ -729,10 +729,9 @@ void adpcm_b_channel::load_start()
 //-------------------------------------------------
 
 adpcm_b_engine::adpcm_b_engine(ymfm_interface &intf, uint32_t addrshift) :
-	m_intf(intf)
+	m_intf(intf),
+	m_channel(*this, addrshift)
 {
-	// create the channel (only one supported for now, but leaving possibilities open)
-	m_channel = std::make_unique<adpcm_b_channel>(*this, addrshift);
 }
 
 
@@ -746,7 +745,7 @@ void adpcm_b_engine::reset()
 	m_regs.reset();
 
 	// reset each channel
-	m_channel->reset();
+	m_channel.reset();
 }
 
 
@@ -760,7 +759,7 @@ void adpcm_b_engine::save_restore(ymfm_saved_state &state)
 	m_regs.save_restore(state);
 
 	// save channel state
-	m_channel->save_restore(state);
+	m_channel.save_restore(state);
 }
 
 
@@ -771,7 +770,7 @@ void adpcm_b_engine::save_restore(ymfm_saved_state &state)
 void adpcm_b_engine::clock()
 {
 	// clock each channel, setting a bit in result if it finished
-	m_channel->clock();
+	m_channel.clock();
 }
 
 
@@ -783,7 +782,7 @@ template<int NumOutputs>
 void adpcm_b_engine::output(ymfm_output<NumOutputs> &output, uint32_t rshift)
 {
 	// compute the output of each channel
-	m_channel->output(output, rshift);
+	m_channel.output(output, rshift);
 }
 
 template void adpcm_b_engine::output<1>(ymfm_output<1> &output, uint32_t rshift);
@@ -801,7 +800,7 @@ void adpcm_b_engine::write(uint32_t regnum, uint8_t data)
 	m_regs.write(regnum, data);
 
 	// let the channel handle any special writes
-	m_channel->write(regnum, data);
+	m_channel.write(regnum, data);
 }
 
 }
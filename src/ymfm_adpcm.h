@@ -206,7 +206,7 @@ public:
 private:
 	// internal state
 	ymfm_interface &m_intf;                                 // reference to the interface
-	std::unique_ptr<adpcm_a_channel> m_channel[CHANNELS]; // array of channels
+	ymfm_inline_array<adpcm_a_channel, CHANNELS> m_channel; // array of channels
 	adpcm_a_registers m_regs;                             // registers
 };
 
@@ -385,13 +385,13 @@ public:
 	void output(ymfm_output<NumOutputs> &output, uint32_t rshift);
 
 	// read from the ADPCM-B registers
-	uint32_t read(uint32_t regnum) { return m_channel->read(regnum); }
+	uint32_t read(uint32_t regnum) { return m_channel.read(regnum); }
 
 	// write to the ADPCM-B registers
 	void write(uint32_t regnum, uint8_t data);
 
 	// status
-	uint8_t status() const { return m_channel->status(); }
+	uint8_t status() const { return m_channel.status(); }
 
 	// return a reference to our interface
 	ymfm_interface &intf() { return m_intf; }
@@ -402,7 +402,7 @@ public:
 private:
 	// internal state
 	ymfm_interface &m_intf;                     // reference to our interface
-	std::unique_ptr<adpcm_b_channel> m_channel; // channel pointer
+	adpcm_b_channel m_channel;                  // channel (only one supported for now)
 	adpcm_b_registers m_regs;                   // registers
 };
 
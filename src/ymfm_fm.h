@@ -50,6 +50,13 @@ enum keyon_type : uint32_t
 	KEYON_CSM = 2
 };
 
+// the ways the engine can compute its outputs; generate() picks one per block
+enum output_path : uint32_t
+{
+	OUTPUT_CHANNELS = 0,
+	OUTPUT_RHYTHM = 1
+};
+
 
 
 //*********************************************************
@@ -75,6 +82,21 @@ struct opdata_cache
 	uint32_t eg_sustain;              // sustain level, shifted up to envelope values
 	uint8_t eg_rate[EG_STATES];       // envelope rate, including KSR
 	uint8_t eg_shift = 0;             // envelope shift amount
+	uint8_t lfo_am_enable = 0;        // non-zero if the AM LFO applies (set by the operator)
+	uint8_t ssg_eg_enable = 0;        // non-zero if SSG-EG is enabled (set by the operator)
+};
+
+
+// ======================> chdata_cache
+
+// this class holds channel data decoded from the registers at prepare
+// time, so that the per-sample output paths don't need to decode them
+struct chdata_cache
+{
+	uint32_t algorithm = 0;           // connection algorithm
+	uint32_t feedback = 0;            // operator 1 feedback level (0 = none)
+	uint32_t output_mask = 0;         // mask of outputs the channel sums into
+	bool lfo_am_enable = false;       // true if any operator applies the AM LFO
 };
 
 
@@ -115,18 +137,21 @@ public:
 	//        bool EG_HAS_REVERB: True if the chip has a faux reverb envelope stage (OPQ/OPZ)
 	//           bool EG_HAS_SSG: True if the chip has SSG envelope support (OPN)
 	//      bool MODULATOR_DELAY: True if the modulator is delayed by 1 sample (OPL pre-OPL3)
+	//  bool PHASE_STEP_STATEFUL: True if compute_phase_step() updates state, so dynamic steps must be computed every sample (OPZ)
 	//
 	static constexpr bool DYNAMIC_OPS = false;
 	static constexpr bool EG_HAS_DEPRESS = false;
 	static constexpr bool EG_HAS_REVERB = false;
 	static constexpr bool EG_HAS_SSG = false;
 	static constexpr bool MODULATOR_DELAY = false;
+	static constexpr bool PHASE_STEP_STATEFUL = false;
 
 	// system-wide register defaults
 	uint32_t status_mask() const                     { return 0; } // OPL only
 	uint32_t irq_reset() const                       { return 0; } // OPL only
 	uint32_t noise_enable() const                    { return 0; } // OPM only
 	uint32_t rhythm_enable() const                   { return 0; } // OPL only
+	uint32_t fourop_enable() const                   { return 0; } // OPL3+ only
 
 	// per-operator register defaults
 	uint32_t op_ssg_eg_enable(uint32_t opoffs) const { return 0; } // OPN(A) only
@@ -169,7 +194,7 @@ class fm_operator
 
 public:
 	// constructor
-	fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opoffs);
+	fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opnum, uint32_t opoffs);
 
 	// save/restore
 	void save_restore(ymfm_saved_state &state);
@@ -184,18 +209,51 @@ public:
 	// set the current channel
 	void set_choffs(uint32_t choffs) { m_choffs = choffs; }
 
-	// prepare prior to clocking
-	bool prepare();
+	// prepare prior to clocking; modified indicates our registers changed
+	void prepare(bool modified);
 
-	// master clocking function
-	void clock(uint32_t env_counter, int32_t lfo_raw_pm);
+	// master clocking function; the phase is advanced separately by the engine
+	void clock(uint32_t env_counter);
+
+	// return the envelope counter value at which the envelope next changes;
+	// the attenuation and envelope state are constant until then
+	uint32_t env_next() const { return m_env_next; }
+
+	// return true if the cached phase step depends on the PM LFO
+	bool phase_step_dynamic() const { return m_cache.phase_step == opdata_cache::PHASE_STEP_DYNAMIC; }
+
+	// return true if SSG-EG is enabled, as of the last prepare
+	bool ssg_eg_enable() const { return m_cache.ssg_eg_enable != 0; }
+
+	// return true if the operator is quiet and can't get louder until the
+	// next key on; compute_volume returns 0 until then, while the OPM noise
+	// (if noise is true) is heard until the envelope is fully off
+	bool silent_until_keyon(bool noise = false) const
+	{
+		return (m_env_state == EG_RELEASE || (RegisterType::EG_HAS_REVERB && m_env_state == EG_REVERB)) &&
+			m_env_attenuation > (noise ? 0x3fe : EG_QUIET) && !m_cache.ssg_eg_enable;
+	}
+
+	// return true if the operator can still be heard before the next key on
+	bool active(bool noise = false) const { return !silent_until_keyon(noise); }
+
+	// compute the phase step for operators whose step varies with the PM LFO
+	uint32_t compute_phase_step(int32_t lfo_raw_pm) { return m_regs.compute_phase_step(m_choffs, m_opoffs, m_cache, lfo_raw_pm); }
 
 	// return the current phase value
 	uint32_t phase() const { return m_phase >> 10; }
 
+	// return the phase value after the given number of clocks, assuming the
+	// phase step doesn't change in between
+	uint32_t phase_after(uint32_t clocks) const { return (m_phase + m_phase_step * clocks) >> 10; }
+
 	// compute operator volume
 	int32_t compute_volume(uint32_t phase, uint32_t am_offset) const;
 
+	// compute operator volumes over a block of upcoming clocks, given a phase
+	// modulation and AM LFO offset for each; the envelope must not change
+	void compute_volume_block(uint32_t count, int32_t const *phase_offset, uint32_t const *am_offset, int32_t *result) const;
+
 	// compute volume for the OPM noise channel
 	int32_t compute_noise_volume(uint32_t am_offset) const;
 
@@ -222,7 +280,9 @@ private:
 	void clock_keystate(uint32_t keystate);
 	void clock_ssg_eg_state();
 	void clock_envelope(uint32_t env_counter);
-	void clock_phase(int32_t lfo_raw_pm);
+
+	// compute the next envelope event after the given envelope counter
+	void update_env_next(uint32_t env_counter);
 
 	// return effective attenuation of the envelope
 	uint32_t envelope_attenuation(uint32_t am_offset) const;
@@ -230,9 +290,11 @@ private:
 	// internal state
 	uint32_t m_choffs;                     // channel offset in registers
 	uint32_t m_opoffs;                     // operator offset in registers
-	uint32_t m_phase;                      // current phase value (10.10 format)
-	uint16_t m_env_attenuation;            // computed envelope attenuation (4.6 format)
-	envelope_state m_env_state;            // current envelope state
+	uint32_t &m_phase;                     // current phase value (10.10 format)
+	uint32_t &m_phase_step;                // phase step applied by the engine each clock
+	uint16_t &m_env_attenuation;           // computed envelope attenuation (4.6 format)
+	envelope_state &m_env_state;           // current envelope state
+	uint32_t m_env_next;                   // envelope counter value of the next envelope event
 	uint8_t m_ssg_inverted;                // non-zero if the output should be inverted (bit 0)
 	uint8_t m_key_state;                   // current key state: on or off (bit 0)
 	uint8_t m_keyon_live;                  // live key on state (bit 0 = direct, bit 1 = rhythm, bit 2 = CSM)
@@ -251,6 +313,9 @@ class fm_channel
 {
 	using output_data = ymfm_output<RegisterType::OUTPUTS>;
 
+	// the engine computes blocks of samples directly from our state
+	friend class fm_engine_base<RegisterType>;
+
 public:
 	// constructor
 	fm_channel(fm_engine_base<RegisterType> &owner, uint32_t choffs);
@@ -276,15 +341,36 @@ public:
 	// signal key on/off to our operators
 	void keyonoff(uint32_t states, keyon_type type, uint32_t chnum);
 
-	// prepare prior to clocking
-	bool prepare();
+	// prepare prior to clocking; modified indicates our registers changed
+	bool prepare(bool modified);
+
+	// refresh what depends on our operators going quiet; returns true if
+	// we're still active
+	bool update_activity();
 
 	// master clocking function
-	void clock(uint32_t env_counter, int32_t lfo_raw_pm);
+	void clock();
+
+	// compute the output using the kernel selected by prepare()
+	void output(output_data &output, uint32_t rshift, int32_t clipmax) const { (this->*m_output)(output, rshift, clipmax); }
+
+	// compute just operator 1 to update the feedback, as output() would
+	void output_feedback() const;
+
+	// clock the feedback and compute the outputs for a block of upcoming
+	// clocks over which only the phases change, one operator at a time; the
+	// output for each sample is stride entries after the previous one
+	void output_block(output_data *output, uint32_t stride, uint32_t count, uint32_t const *am_offset, uint32_t rshift, int32_t clipmax);
 
 	// specific 2-operator and 4-operator output handlers
-	void output_2op(output_data &output, uint32_t rshift, int32_t clipmax) const;
-	void output_4op(output_data &output, uint32_t rshift, int32_t clipmax) const;
+	void output_2op(output_data &output, uint32_t rshift, int32_t clipmax) const { (this->*kernel_2op())(output, rshift, clipmax); }
+	void output_4op(output_data &output, uint32_t rshift, int32_t clipmax) const { (this->*kernel_4op())(output, rshift, clipmax); }
+
+	// return the parameters of the current algorithm (see s_algorithm_ops)
+	uint32_t algorithm_ops() const { return algorithm_ops(m_cache.algorithm); }
+
+	// return the parameters of the given algorithm
+	static uint32_t algorithm_ops(uint32_t algorithm);
 
 	// compute the special OPL rhythm channel outputs
 	void output_rhythm_ch6(output_data &output, uint32_t rshift, int32_t clipmax) const;
@@ -306,8 +392,40 @@ public:
 	fm_operator<RegisterType> *debug_operator(uint32_t index) const { return m_op[index]; }
 
 private:
+	// output kernel, specialized for a single algorithm
+	using output_func = void (fm_channel::*)(output_data &output, uint32_t rshift, int32_t clipmax) const;
+
+	// return the kernel for the current algorithm
+	output_func kernel_2op() const;
+	output_func kernel_4op() const;
+
+	// generic output handler, used until the first prepare
+	void output_generic(output_data &output, uint32_t rshift, int32_t clipmax) const
+	{
+		if (is4op())
+			output_4op(output, rshift, clipmax);
+		else
+			output_2op(output, rshift, clipmax);
+	}
+
+	// output kernels, instantiated for each algorithm
+	template<uint32_t Algorithm> void output_2op_alg(output_data &output, uint32_t rshift, int32_t clipmax) const;
+	template<uint32_t Algorithm, bool Noise> void output_4op_alg(output_data &output, uint32_t rshift, int32_t clipmax) const;
+
+	// decode the channel registers into the cache
+	void cache_channel_data();
+
+	// return true if any of our operators can still be heard
+	bool active() const;
+
+	// return a mask of the operators that can affect the output
+	uint32_t output_ops() const;
+
+	// return the AM offset to pass to our operators; 0 if none of them use it
+	uint32_t lfo_am_offset() const { return m_cache.lfo_am_enable ? m_regs.lfo_am_offset(m_choffs) : 0; }
+
 	// helper to add values to the outputs based on channel enables
-	void add_to_output(uint32_t choffs, output_data &output, int32_t value) const
+	void add_to_output(output_data &output, int32_t value) const
 	{
 		// create these constants to appease overzealous compilers checking array
 		// bounds in unreachable code (looking at you, clang)
@@ -316,13 +434,13 @@ private:
 		constexpr int out2_index = 2 % RegisterType::OUTPUTS;
 		constexpr int out3_index = 3 % RegisterType::OUTPUTS;
 
-		if (RegisterType::OUTPUTS == 1 || m_regs.ch_output_0(choffs))
+		if (bitfield(m_cache.output_mask, 0))
 			output.data[out0_index] += value;
-		if (RegisterType::OUTPUTS >= 2 && m_regs.ch_output_1(choffs))
+		if (RegisterType::OUTPUTS >= 2 && bitfield(m_cache.output_mask, 1))
 			output.data[out1_index] += value;
-		if (RegisterType::OUTPUTS >= 3 && m_regs.ch_output_2(choffs))
+		if (RegisterType::OUTPUTS >= 3 && bitfield(m_cache.output_mask, 2))
 			output.data[out2_index] += value;
-		if (RegisterType::OUTPUTS >= 4 && m_regs.ch_output_3(choffs))
+		if (RegisterType::OUTPUTS >= 4 && bitfield(m_cache.output_mask, 3))
 			output.data[out3_index] += value;
 	}
 
@@ -331,6 +449,9 @@ private:
 	int16_t m_feedback[2];                 // feedback memory for operator 1
 	mutable int16_t m_feedback_in;         // next input value for op 1 feedback (set in output)
 	fm_operator<RegisterType> *m_op[4];    // up to 4 operators
+	output_func m_output;                  // output kernel for the current algorithm
+	chdata_cache m_cache;                  // decoded channel registers
+	uint32_t m_output_ops;                 // mask of operators the output kernels compute
 	RegisterType &m_regs;                  // direct reference to registers
 	fm_engine_base<RegisterType> &m_owner; // reference to the owning engine
 };
@@ -344,6 +465,9 @@ private:
 template<class RegisterType>
 class fm_engine_base : public ymfm_engine_callbacks
 {
+	// operators keep their clocked state in our parallel arrays
+	friend class fm_operator<RegisterType>;
+
 public:
 	// expose some constants from the registers
 	static constexpr uint32_t OUTPUTS = RegisterType::OUTPUTS;
@@ -357,6 +481,10 @@ public:
 	static constexpr uint8_t STATUS_BUSY = RegisterType::STATUS_BUSY;
 	static constexpr uint8_t STATUS_IRQ = RegisterType::STATUS_IRQ;
 
+	// maximum number of samples generate() computes together when only the
+	// phases change
+	static constexpr uint32_t BLOCK_SAMPLES = 16;
+
 	// expose the correct output class
 	using output_data = ymfm_output<OUTPUTS>;
 
@@ -375,6 +503,20 @@ public:
 	// compute sum of channel outputs
 	void output(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const;
 
+	// clock and compute the outputs for a block of samples
+	void generate(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask);
+
+	// clock a block of samples, computing the output of each channel in outmask
+	// separately; output holds CHANNELS entries per sample (not for rhythm mode)
+	void generate_channels(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask);
+
+	// update the state output() would update, without computing any outputs
+	void update_feedback(uint32_t chanmask, bool all = true) const;
+
+	// clock a block of samples, leaving the state as generate() would; outmask
+	// specifies the channels whose outputs would have been computed
+	void advance(uint32_t numsamples, uint32_t chanmask, uint32_t outmask);
+
 	// write to the OPN registers
 	void write(uint16_t regnum, uint8_t data);
 
@@ -392,6 +534,9 @@ public:
 	// set the IRQ mask
 	void set_irq_mask(uint8_t mask) { m_irq_mask = mask; m_intf.ymfm_sync_check_interrupts(); }
 
+	// return the number of upcoming clocks over which no envelope changes
+	uint32_t envelope_horizon() const;
+
 	// return the current clock prescale
 	uint32_t clock_prescale() const { return m_clock_prescale; }
 
@@ -415,11 +560,11 @@ public:
 	RegisterType &regs() { return m_regs; }
 
 	// invalidate any caches
-	void invalidate_caches() { m_modified_channels = RegisterType::ALL_CHANNELS; }
+	void invalidate_caches() { m_modified_channels = RegisterType::ALL_CHANNELS; m_prepare_pending = true; }
 
 	// simple getters for debugging
-	fm_channel<RegisterType> *debug_channel(uint32_t index) const { return m_channel[index].get(); }
-	fm_operator<RegisterType> *debug_operator(uint32_t index) const { return m_operator[index].get(); }
+	fm_channel<RegisterType> *debug_channel(uint32_t index) const { return const_cast<fm_channel<RegisterType> *>(&m_channel[index]); }
+	fm_operator<RegisterType> *debug_operator(uint32_t index) const { return const_cast<fm_operator<RegisterType> *>(&m_operator[index]); }
 
 public:
 	// timer callback; called by the interface when a timer fires
@@ -435,6 +580,50 @@ protected:
 	// assign the current set of operators to channels
 	void assign_operators();
 
+	// prepare the requested channels for clocking
+	void prepare(uint32_t chanmask);
+
+	// update the active channels after an operator went quiet
+	void update_activity();
+
+	// build the lists of operators to clock
+	void build_clock_lists(uint32_t chanmask);
+
+	// advance the envelope, LFO, and operator state by one sample
+	uint32_t clock_state(uint32_t chanmask);
+
+	// return the number of upcoming clocks that clock_silent can cover
+	uint32_t silent_horizon(uint32_t chanmask) const;
+
+	// advance the state by the given number of clocks while nothing is active
+	uint32_t clock_silent(uint32_t chanmask, uint32_t count);
+
+	// advance the envelope counter by the given number of clocks
+	void clock_env_counter(uint32_t count);
+
+	// return the number of upcoming clocks that generate_block can cover
+	uint32_t block_horizon(uint32_t outmask) const;
+
+	// clock and compute the outputs for a block of samples over which only
+	// the phases change, one operator stage at a time across the block; if
+	// split, each sample has CHANNELS outputs, one per channel
+	void generate_block(output_data *output, bool split, uint32_t count, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask);
+
+	// recompute the phase steps of operators affected by the PM LFO as needed
+	void update_dynamic_steps(int32_t lfo_raw_pm);
+
+	// clock and compute the outputs for a block of samples using the given
+	// path; if Split, each sample has CHANNELS outputs, one per channel
+	template<output_path Path, bool Split>
+	void generate_path(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask);
+
+	// compute the outputs of channels in rhythm mode
+	void output_rhythm(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const;
+
+	// compute the outputs of channels one at a time; if split, each channel
+	// goes to output[chnum] instead of output[0]
+	void output_channels(output_data *output, bool split, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const;
+
 	// update the state of the given timer
 	void update_timer(uint32_t which, uint32_t enable, int32_t delta_clocks);
 
@@ -448,11 +637,25 @@ protected:
 	uint8_t m_timer_running[2];      // current timer running state
 	uint8_t m_total_clocks;          // low 8 bits of the total number of clocks processed
 	uint32_t m_active_channels;      // mask of active channels (computed by prepare)
-	uint32_t m_modified_channels;    // mask of channels that have been modified
-	uint32_t m_prepare_count;        // counter to do periodic prepare sweeps
+	uint32_t m_modified_channels;    // mask of channels whose registers have been modified
+	bool m_prepare_pending;          // a write or CSM key on occurred; sweep key states on the next clock
+	bool m_activity_pending;         // an operator went quiet; update the active channels
+	uint32_t m_prepared_chanmask;    // channel mask used by the last prepare
+	uint32_t m_clock_op_count;       // number of entries in m_clock_ops
+	uint32_t m_dynamic_op_count;     // number of entries in m_dynamic_ops
+	int32_t m_dynamic_pm;            // raw PM value the dynamic phase steps were computed for
+	bool m_dynamic_valid;            // true if the dynamic phase steps are up to date
 	RegisterType m_regs;             // register accessor
-	std::unique_ptr<fm_channel<RegisterType>> m_channel[CHANNELS]; // channel pointers
-	std::unique_ptr<fm_operator<RegisterType>> m_operator[OPERATORS]; // operator pointers
+	uint32_t m_op_phase[OPERATORS];  // per-operator phase (10.10 format)
+	uint32_t m_op_phase_step[OPERATORS]; // per-operator phase step (0 if not clocked)
+	uint16_t m_op_env_attenuation[OPERATORS]; // per-operator envelope attenuation (4.6 format)
+	envelope_state m_op_env_state[OPERATORS]; // per-operator envelope state
+	typename RegisterType::operator_mapping m_op_map; // current operator to channel mapping
+	uint32_t m_op_map_fourop;        // 4-operator enables the mapping was built for
+	uint8_t m_clock_ops[OPERATORS];  // operators clocked each sample, in order
+	uint8_t m_dynamic_ops[OPERATORS]; // operators whose phase step is computed each sample
+	ymfm_inline_array<fm_channel<RegisterType>, CHANNELS> m_channel; // channels
+	ymfm_inline_array<fm_operator<RegisterType>, OPERATORS> m_operator; // operators
 #if (DEBUG_LOG_WAVFILES)
 	mutable ymfm_wavfile<1> m_wavfile[CHANNELS]; // for debugging
 #endif
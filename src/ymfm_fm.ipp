@@ -371,18 +371,25 @@ inline int32_t opn_lfo_pm_phase_adjustment(uint32_t fnum_bits, uint32_t pm_sensi
 //-------------------------------------------------
 
 template<class RegisterType>
-fm_operator<RegisterType>::fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opoffs) :
+fm_operator<RegisterType>::fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opnum, uint32_t opoffs) :
 	m_choffs(0),
 	m_opoffs(opoffs),
-	m_phase(0),
-	m_env_attenuation(0x3ff),
-	m_env_state(EG_RELEASE),
+	m_phase(owner.m_op_phase[opnum]),
+	m_phase_step(owner.m_op_phase_step[opnum]),
+	m_env_attenuation(owner.m_op_env_attenuation[opnum]),
+	m_env_state(owner.m_op_env_state[opnum]),
+	m_env_next(0),
 	m_ssg_inverted(false),
 	m_key_state(0),
 	m_keyon_live(0),
 	m_regs(owner.regs()),
 	m_owner(owner)
 {
+	// the state itself lives in the owner's arrays
+	m_phase = 0;
+	m_phase_step = 0;
+	m_env_attenuation = 0x3ff;
+	m_env_state = EG_RELEASE;
 }
 
 
@@ -397,6 +404,7 @@ void fm_operator<RegisterType>::reset()
 	m_phase = 0;
 	m_env_attenuation = 0x3ff;
 	m_env_state = EG_RELEASE;
+	m_env_next = m_owner.m_env_counter;
 	m_ssg_inverted = 0;
 	m_key_state = 0;
 	m_keyon_live = 0;
@@ -424,17 +432,30 @@ void fm_operator<RegisterType>::save_restore(ymfm_saved_state &state)
 //-------------------------------------------------
 
 template<class RegisterType>
-bool fm_operator<RegisterType>::prepare()
+void fm_operator<RegisterType>::prepare(bool modified)
 {
-	// cache the data
-	m_regs.cache_operator_data(m_choffs, m_opoffs, m_cache);
+	// if our registers changed, re-cache the data and publish the phase
+	// step to the engine
+	if (modified)
+	{
+		m_regs.cache_operator_data(m_choffs, m_opoffs, m_cache);
+		m_cache.lfo_am_enable = m_regs.op_lfo_am_enable(m_opoffs);
+		m_cache.ssg_eg_enable = m_regs.op_ssg_eg_enable(m_opoffs);
+		m_phase_step = m_cache.phase_step;
+	}
 
-	// clock the key state
+	// clock the key state; a CSM key on only lasts until the next clock,
+	// so have the engine prepare again then to release it
 	clock_keystate(uint32_t(m_keyon_live != 0));
-	m_keyon_live &= ~(1 << KEYON_CSM);
+	if (bitfield(m_keyon_live, KEYON_CSM))
+	{
+		m_keyon_live &= ~(1 << KEYON_CSM);
+		m_owner.m_prepare_pending = true;
+	}
 
-	// we're active until we're quiet after the release
-	return (m_env_state != (RegisterType::EG_HAS_REVERB ? EG_REVERB : EG_RELEASE) || m_env_attenuation < EG_QUIET);
+	// the rates or envelope state may have changed, so clock the envelope
+	// on the next envelope cycle and work out the next event from there
+	m_env_next = m_owner.m_env_counter;
 }
 
 
@@ -443,20 +464,31 @@ bool fm_operator<RegisterType>::prepare()
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_operator<RegisterType>::clock(uint32_t env_counter, int32_t lfo_raw_pm)
+void fm_operator<RegisterType>::clock(uint32_t env_counter)
 {
+	uint32_t const prev_attenuation = m_env_attenuation;
+	envelope_state const prev_state = m_env_state;
+
 	// clock the SSG-EG state (OPN/OPNA)
-	if (m_regs.op_ssg_eg_enable(m_opoffs))
+	if (m_cache.ssg_eg_enable)
 		clock_ssg_eg_state();
 	else
 		m_ssg_inverted = false;
 
-	// clock the envelope if on an envelope cycle; env_counter is a x.2 value
-	if (bitfield(env_counter, 0, 2) == 0)
+	// clock the envelope if on an envelope cycle and something can change;
+	// env_counter is a x.2 value
+	if (bitfield(env_counter, 0, 2) == 0 && int32_t(env_counter - m_env_next) >= 0)
+	{
 		clock_envelope(env_counter >> 2);
+		update_env_next(env_counter);
+	}
 
-	// clock the phase
-	clock_phase(lfo_raw_pm);
+	// once silent after the release we can only get louder on a key on; tell
+	// the engine as we cross into that, and again once the envelope is fully
+	// off for the OPM noise, so it can stop computing us
+	if (silent_until_keyon() && (m_env_state != prev_state || prev_attenuation <= EG_QUIET ||
+		(m_env_attenuation == 0x3ff && prev_attenuation != 0x3ff)))
+		m_owner.m_activity_pending = true;
 }
 
 
@@ -490,6 +522,29 @@ int32_t fm_operator<RegisterType>::compute_volume(uint32_t phase, uint32_t am_of
 }
 
 
+//-------------------------------------------------
+//  compute_volume_block - compute the volumes of
+//  this operator over a block of upcoming clocks,
+//  given a phase modulation and an AM LFO offset
+//  for each; the envelope must be constant and
+//  the phase step fixed across the block
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_operator<RegisterType>::compute_volume_block(uint32_t count, int32_t const *phase_offset, uint32_t const *am_offset, int32_t *result) const
+{
+	// early out if the envelope is effectively off for the whole block
+	if (m_env_attenuation > EG_QUIET)
+	{
+		std::fill_n(result, count, 0);
+		return;
+	}
+
+	for (uint32_t samp = 0; samp < count; samp++)
+		result[samp] = compute_volume(phase_after(samp + 1) + phase_offset[samp], am_offset[samp]);
+}
+
+
 //-------------------------------------------------
 //  compute_noise_volume - compute the 14-bit
 //  signed noise volume of this operator, given a
@@ -718,7 +773,7 @@ void fm_operator<RegisterType>::clock_envelope(uint32_t env_counter)
 	else
 	{
 		// non-SSG-EG cases just apply the increment
-		if (!m_regs.op_ssg_eg_enable(m_opoffs))
+		if (!m_cache.ssg_eg_enable)
 			m_env_attenuation += increment;
 
 		// SSG-EG only applies if less than mid-point, and then at 4x
@@ -741,21 +796,52 @@ void fm_operator<RegisterType>::clock_envelope(uint32_t env_counter)
 
 
 //-------------------------------------------------
-//  clock_phase - clock the 10.10 phase value; the
-//  OPN version of the logic has been verified
-//  against the Nuked phase generator
+//  update_env_next - compute the envelope counter
+//  value of the next envelope cycle that can
+//  change the attenuation or envelope state,
+//  given the one that was just clocked; cycles
+//  in between only fail the rate check in
+//  clock_envelope, so skipping them is exact
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_operator<RegisterType>::clock_phase(int32_t lfo_raw_pm)
+void fm_operator<RegisterType>::update_env_next(uint32_t env_counter)
 {
-	// read from the cache, or recalculate if PM active
-	uint32_t phase_step = m_cache.phase_step;
-	if (phase_step == opdata_cache::PHASE_STEP_DYNAMIC)
-		phase_step = m_regs.compute_phase_step(m_choffs, m_opoffs, m_cache, lfo_raw_pm);
+	// SSG-EG can change the state on any sample, so evaluate every cycle
+	if (RegisterType::EG_HAS_SSG && m_cache.ssg_eg_enable)
+	{
+		m_env_next = env_counter + 4;
+		return;
+	}
+
+	// pending attack->decay or decay->sustain transitions happen next cycle
+	if ((m_env_state == EG_ATTACK && m_env_attenuation == 0) || (m_env_state == EG_DECAY && m_env_attenuation >= m_cache.eg_sustain))
+	{
+		m_env_next = env_counter + 4;
+		return;
+	}
+
+	// determine if the envelope is stuck where it is: rates 0-1 never
+	// increment, attack at rates 62-63 doesn't increment after key on, and
+	// other states stop at maximum attenuation unless they transition there
+	uint32_t rate = m_cache.eg_rate[m_env_state];
+	bool stuck = (rate < 2);
+	if (m_env_state == EG_ATTACK)
+		stuck |= (rate >= 62);
+	else if (m_env_attenuation == 0x3ff)
+		stuck |= !(RegisterType::EG_HAS_DEPRESS && m_env_state == EG_DEPRESS) && !(RegisterType::EG_HAS_REVERB && m_env_state == EG_RELEASE);
+	if (stuck)
+	{
+		// re-evaluate eventually so that comparisons survive counter wraparound
+		m_env_next = env_counter + 0x40000000;
+		return;
+	}
 
-	// finally apply the step to the current phase value
-	m_phase += phase_step;
+	// otherwise, the next event is the next cycle where the low bits of
+	// the counter shifted by the rate are all 0
+	uint32_t rate_shift = rate >> 2;
+	uint32_t mask = (rate_shift >= 11) ? 0 : ((1 << (11 - rate_shift)) - 1);
+	m_env_next = (((env_counter >> 2) + 1 + mask) & ~mask) << 2;
 }
 
 
@@ -774,7 +860,7 @@ uint32_t fm_operator<RegisterType>::envelope_attenuation(uint32_t am_offset) con
 		result = (0x200 - result) & 0x3ff;
 
 	// add in LFO AM modulation
-	if (m_regs.op_lfo_am_enable(m_opoffs))
+	if (m_cache.lfo_am_enable)
 		result += am_offset;
 
 	// add in total level and KSL from the cache
@@ -800,6 +886,9 @@ fm_channel<RegisterType>::fm_channel(fm_engine_base<RegisterType> &owner, uint32
 	m_feedback{ 0, 0 },
 	m_feedback_in(0),
 	m_op{ nullptr, nullptr, nullptr, nullptr },
+	m_output(&fm_channel::output_generic),
+	m_cache(),
+	m_output_ops(0xf),
 	m_regs(owner.regs()),
 	m_owner(owner)
 {
@@ -855,35 +944,145 @@ void fm_channel<RegisterType>::keyonoff(uint32_t states, keyon_type type, uint32
 //-------------------------------------------------
 
 template<class RegisterType>
-bool fm_channel<RegisterType>::prepare()
+bool fm_channel<RegisterType>::prepare(bool modified)
 {
-	uint32_t active_mask = 0;
-
-	// prepare all operators and determine if they are active
+	// prepare all operators
 	for (uint32_t opnum = 0; opnum < array_size(m_op); opnum++)
 		if (m_op[opnum] != nullptr)
-			if (m_op[opnum]->prepare())
-				active_mask |= 1 << opnum;
+			m_op[opnum]->prepare(modified);
+
+	// decode our registers and select the output kernel for the algorithm
+	if (modified)
+	{
+		cache_channel_data();
+		m_output = is4op() ? kernel_4op() : kernel_2op();
+	}
+
+	// work out which operators can reach the output until the next prepare
+	m_output_ops = output_ops();
+
+	return active();
+}
+
+
+//-------------------------------------------------
+//  update_activity - refresh the operators the
+//  output kernels compute after one of ours went
+//  quiet, and return true if we're still active
+//-------------------------------------------------
+
+template<class RegisterType>
+bool fm_channel<RegisterType>::update_activity()
+{
+	m_output_ops = output_ops();
+	return active();
+}
+
+
+//-------------------------------------------------
+//  active - return true if any of our operators
+//  can still be heard before the next key on; the
+//  OPM noise in place of operator 4 is heard
+//  until its envelope is fully off
+//-------------------------------------------------
+
+template<class RegisterType>
+bool fm_channel<RegisterType>::active() const
+{
+	bool const noise = (m_regs.noise_enable() && m_choffs == 7);
+	for (uint32_t opnum = 0; opnum < array_size(m_op); opnum++)
+		if (m_op[opnum] != nullptr && m_op[opnum]->active(noise && opnum == 3))
+			return true;
+	return false;
+}
+
 
-	return (active_mask != 0);
+//-------------------------------------------------
+//  output_ops - return a mask of the operators
+//  that can affect the output until the next
+//  prepare; carriers that are quiet in release
+//  stay silent until a key on, which only
+//  happens in prepare, so they and operators
+//  that only modulate them can be skipped;
+//  operator 1 is always needed for feedback
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_channel<RegisterType>::output_ops() const
+{
+	// find the operators that can't make a sound
+	uint32_t silent = 0;
+	for (uint32_t opnum = 0; opnum < array_size(m_op); opnum++)
+		if (m_op[opnum] != nullptr && m_op[opnum]->silent_until_keyon())
+			silent |= 1 << opnum;
+
+	// operator 2 is the only carrier besides operator 1 in 2-operator mode
+	if (!is4op())
+		return 1 | (~silent & 2);
+
+	// start with the carriers that can be heard; operator 4 is always one
+	uint32_t ops = algorithm_ops();
+	uint32_t result = (8 | bitfield(ops, 7, 3)) & ~silent;
+
+	// then work backwards through the modulators feeding those; this is the
+	// mask of operators summed into each opout[] entry
+	static uint8_t const s_opout_ops[8] = { 0, 1, 2, 4, 0, 1|2, 1|4, 2|4 };
+	if (bitfield(result, 3))
+		result |= s_opout_ops[bitfield(ops, 4, 3)];
+	if (bitfield(result, 2))
+		result |= s_opout_ops[bitfield(ops, 1, 3)];
+	if (bitfield(result, 1))
+		result |= s_opout_ops[bitfield(ops, 0, 1)];
+	return result | 1;
 }
 
 
 //-------------------------------------------------
-//  clock - master clock of all operators
+//  cache_channel_data - decode the channel
+//  registers used by the output paths
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_channel<RegisterType>::clock(uint32_t env_counter, int32_t lfo_raw_pm)
+void fm_channel<RegisterType>::cache_channel_data()
+{
+	m_cache.algorithm = m_regs.ch_algorithm(m_choffs);
+	m_cache.feedback = m_regs.ch_feedback(m_choffs);
+
+	// the outputs are all off if the channel is muted, in which case the
+	// output kernels skip everything past operator 1
+	m_cache.output_mask = 0;
+	if (m_regs.ch_output_any(m_choffs) != 0)
+	{
+		if (RegisterType::OUTPUTS == 1 || m_regs.ch_output_0(m_choffs))
+			m_cache.output_mask |= 1 << 0;
+		if (RegisterType::OUTPUTS >= 2 && m_regs.ch_output_1(m_choffs))
+			m_cache.output_mask |= 1 << 1;
+		if (RegisterType::OUTPUTS >= 3 && m_regs.ch_output_2(m_choffs))
+			m_cache.output_mask |= 1 << 2;
+		if (RegisterType::OUTPUTS >= 4 && m_regs.ch_output_3(m_choffs))
+			m_cache.output_mask |= 1 << 3;
+	}
+
+	// the AM offset only needs computing if an operator consumes it
+	m_cache.lfo_am_enable = false;
+	for (uint32_t opnum = 0; opnum < array_size(m_op); opnum++)
+		if (m_op[opnum] != nullptr && m_regs.op_lfo_am_enable(m_op[opnum]->opoffs()))
+			m_cache.lfo_am_enable = true;
+}
+
+
+//-------------------------------------------------
+//  clock - master clock of the channel; the
+//  operators are clocked by the engine
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_channel<RegisterType>::clock()
 {
 	// clock the feedback through
 	m_feedback[0] = m_feedback[1];
 	m_feedback[1] = m_feedback_in;
 
-	for (uint32_t opnum = 0; opnum < array_size(m_op); opnum++)
-		if (m_op[opnum] != nullptr)
-			m_op[opnum]->clock(env_counter, lfo_raw_pm);
-
 /*
 useful temporary code for envelope debugging
 if (m_choffs == 0x101)
@@ -904,42 +1103,106 @@ printf(" -- ");
 
 
 //-------------------------------------------------
-//  output_2op - combine 4 operators according to
-//  the specified algorithm, returning a sum
+//  kernel_2op - return the 2-operator output
+//  kernel for the current algorithm
+//-------------------------------------------------
+
+template<class RegisterType>
+typename fm_channel<RegisterType>::output_func fm_channel<RegisterType>::kernel_2op() const
+{
+	static output_func const s_kernels[2] =
+	{
+		&fm_channel::output_2op_alg<0>,
+		&fm_channel::output_2op_alg<1>
+	};
+	return s_kernels[bitfield(m_cache.algorithm, 0)];
+}
+
+
+//-------------------------------------------------
+//  kernel_4op - return the 4-operator output
+//  kernel for the current algorithm
+//-------------------------------------------------
+
+template<class RegisterType>
+typename fm_channel<RegisterType>::output_func fm_channel<RegisterType>::kernel_4op() const
+{
+	static output_func const s_kernels[8+4] =
+	{
+		&fm_channel::output_4op_alg<0, false>,
+		&fm_channel::output_4op_alg<1, false>,
+		&fm_channel::output_4op_alg<2, false>,
+		&fm_channel::output_4op_alg<3, false>,
+		&fm_channel::output_4op_alg<4, false>,
+		&fm_channel::output_4op_alg<5, false>,
+		&fm_channel::output_4op_alg<6, false>,
+		&fm_channel::output_4op_alg<7, false>,
+		&fm_channel::output_4op_alg<8, false>,
+		&fm_channel::output_4op_alg<9, false>,
+		&fm_channel::output_4op_alg<10, false>,
+		&fm_channel::output_4op_alg<11, false>
+	};
+
+	// operator 4 of OPM channel 7 can be replaced by noise
+	static output_func const s_noise_kernels[8] =
+	{
+		&fm_channel::output_4op_alg<0, true>,
+		&fm_channel::output_4op_alg<1, true>,
+		&fm_channel::output_4op_alg<2, true>,
+		&fm_channel::output_4op_alg<3, true>,
+		&fm_channel::output_4op_alg<4, true>,
+		&fm_channel::output_4op_alg<5, true>,
+		&fm_channel::output_4op_alg<6, true>,
+		&fm_channel::output_4op_alg<7, true>
+	};
+
+	if (m_regs.noise_enable() && m_choffs == 7)
+		return s_noise_kernels[m_cache.algorithm & 7];
+	return s_kernels[m_cache.algorithm];
+}
+
+
+//-------------------------------------------------
+//  output_2op_alg - combine 2 operators according
+//  to the given algorithm, returning a sum
 //  according to the rshift and clipmax parameters,
 //  which vary between different implementations
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_channel<RegisterType>::output_2op(output_data &output, uint32_t rshift, int32_t clipmax) const
+template<uint32_t Algorithm>
+void fm_channel<RegisterType>::output_2op_alg(output_data &output, uint32_t rshift, int32_t clipmax) const
 {
 	// The first 2 operators should be populated
 	assert(m_op[0] != nullptr);
 	assert(m_op[1] != nullptr);
 
 	// AM amount is the same across all operators; compute it once
-	uint32_t am_offset = m_regs.lfo_am_offset(m_choffs);
+	uint32_t am_offset = lfo_am_offset();
 
 	// operator 1 has optional self-feedback
 	int32_t opmod = 0;
-	uint32_t feedback = m_regs.ch_feedback(m_choffs);
-	if (feedback != 0)
-		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - feedback);
+	if (m_cache.feedback != 0)
+		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - m_cache.feedback);
 
 	// compute the 14-bit volume/value of operator 1 and update the feedback
 	int32_t op1value = m_feedback_in = m_op[0]->compute_volume(m_op[0]->phase() + opmod, am_offset);
 
 	// now that the feedback has been computed, skip the rest if all volumes
 	// are clear; no need to do all this work for nothing
-	if (m_regs.ch_output_any(m_choffs) == 0)
+	if (m_cache.output_mask == 0)
 		return;
 
 	// Algorithms for two-operator case:
 	//    0: O1 -> O2 -> out
 	//    1: (O1 + O2) -> out
+	// operator 2 is skipped if it will be silent (see output_ops)
 	int32_t result;
-	if (bitfield(m_regs.ch_algorithm(m_choffs), 0) == 0)
+	if (Algorithm == 0)
 	{
+		if (!bitfield(m_output_ops, 1))
+			return;
+
 		// some OPL chips use the previous sample for modulation instead of
 		// the current sample
 		opmod = (RegisterType::MODULATOR_DELAY ? m_feedback[1] : op1value) >> 1;
@@ -948,25 +1211,29 @@ void fm_channel<RegisterType>::output_2op(output_data &output, uint32_t rshift,
 	else
 	{
 		result = (RegisterType::MODULATOR_DELAY ? m_feedback[1] : op1value) >> rshift;
-		result += m_op[1]->compute_volume(m_op[1]->phase(), am_offset) >> rshift;
+		if (bitfield(m_output_ops, 1))
+			result += m_op[1]->compute_volume(m_op[1]->phase(), am_offset) >> rshift;
 		int32_t clipmin = -clipmax - 1;
 		result = clamp(result, clipmin, clipmax);
 	}
 
 	// add to the output
-	add_to_output(m_choffs, output, result);
+	add_to_output(output, result);
 }
 
 
 //-------------------------------------------------
-//  output_4op - combine 4 operators according to
-//  the specified algorithm, returning a sum
+//  output_4op_alg - combine 4 operators according
+//  to the given algorithm, returning a sum
 //  according to the rshift and clipmax parameters,
-//  which vary between different implementations
+//  which vary between different implementations;
+//  the algorithm is a template parameter so that
+//  all the connection decoding folds away
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_channel<RegisterType>::output_4op(output_data &output, uint32_t rshift, int32_t clipmax) const
+template<uint32_t Algorithm, bool Noise>
+void fm_channel<RegisterType>::output_4op_alg(output_data &output, uint32_t rshift, int32_t clipmax) const
 {
 	// all 4 operators should be populated
 	assert(m_op[0] != nullptr);
@@ -975,22 +1242,90 @@ void fm_channel<RegisterType>::output_4op(output_data &output, uint32_t rshift,
 	assert(m_op[3] != nullptr);
 
 	// AM amount is the same across all operators; compute it once
-	uint32_t am_offset = m_regs.lfo_am_offset(m_choffs);
+	uint32_t am_offset = lfo_am_offset();
 
 	// operator 1 has optional self-feedback
 	int32_t opmod = 0;
-	uint32_t feedback = m_regs.ch_feedback(m_choffs);
-	if (feedback != 0)
-		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - feedback);
+	if (m_cache.feedback != 0)
+		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - m_cache.feedback);
 
 	// compute the 14-bit volume/value of operator 1 and update the feedback
 	int32_t op1value = m_feedback_in = m_op[0]->compute_volume(m_op[0]->phase() + opmod, am_offset);
 
 	// now that the feedback has been computed, skip the rest if all volumes
 	// are clear; no need to do all this work for nothing
-	if (m_regs.ch_output_any(m_choffs) == 0)
+	if (m_cache.output_mask == 0)
+		return;
+
+	// look up how the operators connect for this algorithm
+	uint32_t const algorithm_ops = fm_channel::algorithm_ops(Algorithm);
+
+	// if no carrier can be heard there is nothing more to do; otherwise
+	// operators that can't affect the output are left at 0 (see output_ops)
+	uint32_t const ops = m_output_ops;
+	if (!Noise && ops == 1 && bitfield(algorithm_ops, 7) == 0)
 		return;
 
+	// populate the opout table
+	int16_t opout[8];
+	opout[0] = 0;
+	opout[1] = op1value;
+
+	// compute the 14-bit volume/value of operator 2
+	opout[2] = 0;
+	if (bitfield(ops, 1))
+	{
+		opmod = opout[bitfield(algorithm_ops, 0, 1)] >> 1;
+		opout[2] = m_op[1]->compute_volume(m_op[1]->phase() + opmod, am_offset);
+	}
+	opout[5] = opout[1] + opout[2];
+
+	// compute the 14-bit volume/value of operator 3
+	opout[3] = 0;
+	if (bitfield(ops, 2))
+	{
+		opmod = opout[bitfield(algorithm_ops, 1, 3)] >> 1;
+		opout[3] = m_op[2]->compute_volume(m_op[2]->phase() + opmod, am_offset);
+	}
+	opout[6] = opout[1] + opout[3];
+	opout[7] = opout[2] + opout[3];
+
+	// compute the 14-bit volume/value of operator 4; this could be a noise
+	// value on the OPM, which is audible even when quiet; all algorithms
+	// consume OP4 output at a minimum
+	int32_t result = 0;
+	if (Noise)
+		result = m_op[3]->compute_noise_volume(am_offset);
+	else if (bitfield(ops, 3))
+	{
+		opmod = opout[bitfield(algorithm_ops, 4, 3)] >> 1;
+		result = m_op[3]->compute_volume(m_op[3]->phase() + opmod, am_offset);
+	}
+	result >>= rshift;
+
+	// optionally add OP1, OP2, OP3
+	int32_t clipmin = -clipmax - 1;
+	if (bitfield(algorithm_ops, 7) != 0)
+		result = clamp(result + (opout[1] >> rshift), clipmin, clipmax);
+	if (bitfield(algorithm_ops, 8) != 0)
+		result = clamp(result + (opout[2] >> rshift), clipmin, clipmax);
+	if (bitfield(algorithm_ops, 9) != 0)
+		result = clamp(result + (opout[3] >> rshift), clipmin, clipmax);
+
+	// add to the output
+	add_to_output(output, result);
+}
+
+
+//-------------------------------------------------
+//  algorithm_ops - return a description of the
+//  operator inputs and outputs for the given
+//  4-operator algorithm
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_channel<RegisterType>::algorithm_ops(uint32_t algorithm)
+{
 	// OPM/OPN offer 8 different connection algorithms for 4 operators,
 	// and OPL3 offers 4 more, which we designate here as 8-11.
 	//
@@ -1031,61 +1366,157 @@ void fm_channel<RegisterType>::output_4op(output_data &output, uint32_t rshift,
 		ALGORITHM(1,0,3, 0,1,0),    // 10: ((O1 -> O2) + (O3 -> O4)) -> out (O2+O4) [same as 4]
 		ALGORITHM(0,2,0, 1,0,1)     // 11: (O1 + (O2 -> O3) + O4) -> out (O1+O3+O4) [unique]
 	};
-	uint32_t algorithm_ops = s_algorithm_ops[m_regs.ch_algorithm(m_choffs)];
+	return s_algorithm_ops[algorithm];
+}
 
-	// populate the opout table
-	int16_t opout[8];
-	opout[0] = 0;
-	opout[1] = op1value;
 
-	// compute the 14-bit volume/value of operator 2
-	opmod = opout[bitfield(algorithm_ops, 0, 1)] >> 1;
-	opout[2] = m_op[1]->compute_volume(m_op[1]->phase() + opmod, am_offset);
-	opout[5] = opout[1] + opout[2];
+//-------------------------------------------------
+//  output_feedback - compute the output of
+//  operator 1 the same way the output kernels do,
+//  updating the feedback without computing the
+//  rest of the channel
+//-------------------------------------------------
 
-	// compute the 14-bit volume/value of operator 3
-	opmod = opout[bitfield(algorithm_ops, 1, 3)] >> 1;
-	opout[3] = m_op[2]->compute_volume(m_op[2]->phase() + opmod, am_offset);
-	opout[6] = opout[1] + opout[3];
-	opout[7] = opout[2] + opout[3];
+template<class RegisterType>
+void fm_channel<RegisterType>::output_feedback() const
+{
+	// AM amount is the same across all operators; compute it once
+	uint32_t am_offset = lfo_am_offset();
 
-	// compute the 14-bit volume/value of operator 4; this could be a noise
-	// value on the OPM; all algorithms consume OP4 output at a minimum
-	int32_t result;
-	if (m_regs.noise_enable() && m_choffs == 7)
-		result = m_op[3]->compute_noise_volume(am_offset);
-	else
+	// operator 1 has optional self-feedback
+	int32_t opmod = 0;
+	if (m_cache.feedback != 0)
+		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - m_cache.feedback);
+
+	// compute the 14-bit volume/value of operator 1 and update the feedback
+	m_feedback_in = m_op[0]->compute_volume(m_op[0]->phase() + opmod, am_offset);
+}
+
+
+//-------------------------------------------------
+//  output_block - clock the feedback through and
+//  compute the outputs for a block of upcoming
+//  clocks over which only the phases change;
+//  apart from operator 1's feedback, each stage
+//  only depends on earlier stages of the same
+//  sample, so the stages are computed across the
+//  whole block one operator at a time
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_channel<RegisterType>::output_block(output_data *output, uint32_t stride, uint32_t count, uint32_t const *am_offset, uint32_t rshift, int32_t clipmax)
+{
+	static constexpr uint32_t BLOCK_SAMPLES = fm_engine_base<RegisterType>::BLOCK_SAMPLES;
+	int16_t opout[8][BLOCK_SAMPLES];
+	int32_t opmod[BLOCK_SAMPLES] = { 0 };
+	int32_t volume[BLOCK_SAMPLES];
+	int32_t result[BLOCK_SAMPLES];
+
+	// operator 1 has optional self-feedback, so it is computed one sample
+	// at a time, clocking the feedback through as clock() would
+	auto &op1 = *m_op[0];
+	for (uint32_t samp = 0; samp < count; samp++)
 	{
-		opmod = opout[bitfield(algorithm_ops, 4, 3)] >> 1;
-		result = m_op[3]->compute_volume(m_op[3]->phase() + opmod, am_offset);
+		m_feedback[0] = m_feedback[1];
+		m_feedback[1] = m_feedback_in;
+		int32_t mod = 0;
+		if (m_cache.feedback != 0)
+			mod = (m_feedback[0] + m_feedback[1]) >> (10 - m_cache.feedback);
+		m_feedback_in = op1.compute_volume(op1.phase_after(samp + 1) + mod, am_offset[samp]);
+
+		// some OPL chips use the previous sample for modulation instead of
+		// the current sample
+		opout[0][samp] = 0;
+		opout[1][samp] = RegisterType::MODULATOR_DELAY ? m_feedback[1] : m_feedback_in;
 	}
-	result >>= rshift;
 
-	// optionally add OP1, OP2, OP3
-	int32_t clipmin = -clipmax - 1;
-	if (bitfield(algorithm_ops, 7) != 0)
-		result = clamp(result + (opout[1] >> rshift), clipmin, clipmax);
-	if (bitfield(algorithm_ops, 8) != 0)
-		result = clamp(result + (opout[2] >> rshift), clipmin, clipmax);
-	if (bitfield(algorithm_ops, 9) != 0)
-		result = clamp(result + (opout[3] >> rshift), clipmin, clipmax);
+	// skip the rest if all volumes are clear
+	if (m_cache.output_mask == 0)
+		return;
 
-	// add to the output
-	add_to_output(m_choffs, output, result);
+	// 2-operator algorithms are described in the same form as 4-operator
+	// ones: either O1 modulates O2, or O1 is added to the output
+	uint32_t const algorithm_ops = is4op() ? this->algorithm_ops() : (bitfield(m_cache.algorithm, 0) ? (1 << 7) : 1);
+
+	// if no carrier can be heard there is nothing more to do; otherwise
+	// operators that can't affect the output are left at 0 (see output_ops)
+	uint32_t const ops = m_output_ops;
+	if (ops == 1 && bitfield(algorithm_ops, 7) == 0)
+		return;
+
+	// compute operator 2, which is the final operator for 2-operator channels
+	std::fill_n(&opout[2][0], count, 0);
+	if (bitfield(ops, 1))
+	{
+		for (uint32_t samp = 0; samp < count; samp++)
+			opmod[samp] = opout[bitfield(algorithm_ops, 0, 1)][samp] >> 1;
+		m_op[1]->compute_volume_block(count, opmod, am_offset, volume);
+		for (uint32_t samp = 0; samp < count; samp++)
+			opout[2][samp] = volume[samp];
+	}
+	for (uint32_t samp = 0; samp < count; samp++)
+		result[samp] = opout[2][samp] >> rshift;
+
+	// operators 3 and 4 only apply to 4-operator channels
+	if (is4op())
+	{
+		std::fill_n(&opout[3][0], count, 0);
+		for (uint32_t samp = 0; samp < count; samp++)
+			opout[5][samp] = opout[1][samp] + opout[2][samp];
+		if (bitfield(ops, 2))
+		{
+			for (uint32_t samp = 0; samp < count; samp++)
+				opmod[samp] = opout[bitfield(algorithm_ops, 1, 3)][samp] >> 1;
+			m_op[2]->compute_volume_block(count, opmod, am_offset, volume);
+			for (uint32_t samp = 0; samp < count; samp++)
+				opout[3][samp] = volume[samp];
+		}
+		for (uint32_t samp = 0; samp < count; samp++)
+		{
+			opout[6][samp] = opout[1][samp] + opout[3][samp];
+			opout[7][samp] = opout[2][samp] + opout[3][samp];
+		}
+
+		std::fill_n(result, count, 0);
+		if (bitfield(ops, 3))
+		{
+			for (uint32_t samp = 0; samp < count; samp++)
+				opmod[samp] = opout[bitfield(algorithm_ops, 4, 3)][samp] >> 1;
+			m_op[3]->compute_volume_block(count, opmod, am_offset, volume);
+			for (uint32_t samp = 0; samp < count; samp++)
+				result[samp] = volume[samp] >> rshift;
+		}
+	}
+
+	// optionally add OP1, OP2, OP3 and add to the output
+	int32_t clipmin = -clipmax - 1;
+	for (uint32_t samp = 0; samp < count; samp++)
+	{
+		int32_t value = result[samp];
+		if (bitfield(algorithm_ops, 7) != 0)
+			value = clamp(value + (opout[1][samp] >> rshift), clipmin, clipmax);
+		if (bitfield(algorithm_ops, 8) != 0)
+			value = clamp(value + (opout[2][samp] >> rshift), clipmin, clipmax);
+		if (bitfield(algorithm_ops, 9) != 0)
+			value = clamp(value + (opout[3][samp] >> rshift), clipmin, clipmax);
+		add_to_output(output[samp * stride], value);
+	}
 }
 
 
 //-------------------------------------------------
 //  output_rhythm_ch6 - special case output
 //  computation for OPL channel 6 in rhythm mode,
-//  which outputs a Bass Drum instrument
+//  which outputs a Bass Drum instrument; a single
+//  operator can't exceed the clip range, so the
+//  clipmax parameter is unused
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_channel<RegisterType>::output_rhythm_ch6(output_data &output, uint32_t rshift, int32_t clipmax) const
+void fm_channel<RegisterType>::output_rhythm_ch6(output_data &output, uint32_t rshift, int32_t) const
 {
 	// AM amount is the same across all operators; compute it once
-	uint32_t am_offset = m_regs.lfo_am_offset(m_choffs);
+	uint32_t am_offset = lfo_am_offset();
 
 	// Bass Drum: this uses operators 12 and 15 (i.e., channel 6)
 	// in an almost-normal way, except that if the algorithm is 1,
@@ -1093,19 +1524,18 @@ void fm_channel<RegisterType>::output_rhythm_ch6(output_data &output, uint32_t r
 
 	// operator 1 has optional self-feedback
 	int32_t opmod = 0;
-	uint32_t feedback = m_regs.ch_feedback(m_choffs);
-	if (feedback != 0)
-		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - feedback);
+	if (m_cache.feedback != 0)
+		opmod = (m_feedback[0] + m_feedback[1]) >> (10 - m_cache.feedback);
 
 	// compute the 14-bit volume/value of operator 1 and update the feedback
 	int32_t opout1 = m_feedback_in = m_op[0]->compute_volume(m_op[0]->phase() + opmod, am_offset);
 
 	// compute the 14-bit volume/value of operator 2, which is the result
-	opmod = bitfield(m_regs.ch_algorithm(m_choffs), 0) ? 0 : (opout1 >> 1);
+	opmod = bitfield(m_cache.algorithm, 0) ? 0 : (opout1 >> 1);
 	int32_t result = m_op[1]->compute_volume(m_op[1]->phase() + opmod, am_offset) >> rshift;
 
 	// add to the output
-	add_to_output(m_choffs, output, result * 2);
+	add_to_output(output, result * 2);
 }
 
 
@@ -1120,7 +1550,7 @@ template<class RegisterType>
 void fm_channel<RegisterType>::output_rhythm_ch7(uint32_t phase_select, output_data &output, uint32_t rshift, int32_t clipmax) const
 {
 	// AM amount is the same across all operators; compute it once
-	uint32_t am_offset = m_regs.lfo_am_offset(m_choffs);
+	uint32_t am_offset = lfo_am_offset();
 	uint32_t noise_state = bitfield(m_regs.noise_state(), 0);
 
 	// High Hat: this uses the envelope from operator 13 (channel 7),
@@ -1137,7 +1567,7 @@ void fm_channel<RegisterType>::output_rhythm_ch7(uint32_t phase_select, output_d
 	result = clamp(result, -clipmax - 1, clipmax);
 
 	// add to the output
-	add_to_output(m_choffs, output, result * 2);
+	add_to_output(output, result * 2);
 }
 
 
@@ -1151,7 +1581,7 @@ template<class RegisterType>
 void fm_channel<RegisterType>::output_rhythm_ch8(uint32_t phase_select, output_data &output, uint32_t rshift, int32_t clipmax) const
 {
 	// AM amount is the same across all operators; compute it once
-	uint32_t am_offset = m_regs.lfo_am_offset(m_choffs);
+	uint32_t am_offset = lfo_am_offset();
 
 	// Tom Tom: this is just a single operator processed normally
 	int32_t result = m_op[0]->compute_volume(m_op[0]->phase(), am_offset) >> rshift;
@@ -1163,7 +1593,7 @@ void fm_channel<RegisterType>::output_rhythm_ch8(uint32_t phase_select, output_d
 	result = clamp(result, -clipmax - 1, clipmax);
 
 	// add to the output
-	add_to_output(m_choffs, output, result * 2);
+	add_to_output(output, result * 2);
 }
 
 
@@ -1187,18 +1617,25 @@ fm_engine_base<RegisterType>::fm_engine_base(ymfm_interface &intf) :
 	m_timer_running{0,0},
 	m_active_channels(ALL_CHANNELS),
 	m_modified_channels(ALL_CHANNELS),
-	m_prepare_count(0)
+	m_prepare_pending(true),
+	m_activity_pending(false),
+	m_prepared_chanmask(0),
+	m_clock_op_count(0),
+	m_dynamic_op_count(0),
+	m_dynamic_pm(0),
+	m_dynamic_valid(false),
+	m_op_map_fourop(0)
 {
 	// inform the interface of their engine
 	m_intf.m_engine = this;
 
 	// create the channels
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum] = std::make_unique<fm_channel<RegisterType>>(*this, RegisterType::channel_offset(chnum));
+		m_channel.construct(chnum, *this, RegisterType::channel_offset(chnum));
 
 	// create the operators
 	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
-		m_operator[opnum] = std::make_unique<fm_operator<RegisterType>>(*this, RegisterType::operator_offset(opnum));
+		m_operator.construct(opnum, *this, opnum, RegisterType::operator_offset(opnum));
 
 #if (DEBUG_LOG_WAVFILES)
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
@@ -1222,6 +1659,7 @@ void fm_engine_base<RegisterType>::reset()
 
 	// register type-specific initialization
 	m_regs.reset();
+	invalidate_caches();
 
 	// explicitly write to the mode register since it has side-effects
 	// QUESTION: old cores initialize this to 0x30 -- who is right?
@@ -1229,11 +1667,11 @@ void fm_engine_base<RegisterType>::reset()
 
 	// reset the channels
 	for (auto &chan : m_channel)
-		chan->reset();
+		chan.reset();
 
 	// reset the operators
 	for (auto &op : m_operator)
-		op->reset();
+		op.reset();
 }
 
 
@@ -1259,11 +1697,11 @@ void fm_engine_base<RegisterType>::save_restore(ymfm_saved_state &state)
 
 	// save channel data
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum]->save_restore(state);
+		m_channel[chnum].save_restore(state);
 
 	// save operator data
 	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
-		m_operator[opnum]->save_restore(state);
+		m_operator[opnum].save_restore(state);
 
 	// invalidate any caches
 	invalidate_caches();
@@ -1278,28 +1716,296 @@ void fm_engine_base<RegisterType>::save_restore(ymfm_saved_state &state)
 template<class RegisterType>
 uint32_t fm_engine_base<RegisterType>::clock(uint32_t chanmask)
 {
+	// with nothing active, skip the work that can't affect anything
+	if (silent_horizon(chanmask) != 0)
+		return clock_silent(chanmask, 1);
+
 	// update the clock counter
 	m_total_clocks++;
 
-	// if something was modified, prepare
-	// also prepare every 4k samples to catch ending notes
-	if (m_modified_channels != 0 || m_prepare_count++ >= 4096)
+	// if something was written or a different set of channels is requested,
+	// prepare; otherwise catch up with any operators that went quiet
+	if (m_prepare_pending || chanmask != m_prepared_chanmask)
+		prepare(chanmask);
+	else if (m_activity_pending)
+		update_activity();
+
+	// advance the state and return the envelope counter as it is used to clock ADPCM-A
+	return clock_state(chanmask);
+}
+
+
+//-------------------------------------------------
+//  output - compute a sum over the relevant
+//  channels
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::output(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const
+{
+	// mask out some channels for debug purposes
+	chanmask &= debug::GLOBAL_FM_CHANNEL_MASK;
+
+	// mask out inactive channels
+	if (!DEBUG_LOG_WAVFILES)
+		chanmask &= m_active_channels;
+
+	// handle the rhythm case, where some of the operators are dedicated
+	// to percussion (this is an OPL-specific feature)
+	if (m_regs.rhythm_enable())
+		output_rhythm(output, rshift, clipmax, chanmask);
+	else
+		output_channels(&output, false, rshift, clipmax, chanmask);
+}
+
+
+//-------------------------------------------------
+//  generate - clock and compute the outputs for
+//  a block of samples; equivalent to calling
+//  clock() followed by output() on a cleared
+//  output for each sample, but since registers
+//  can only change between blocks, the output
+//  path is picked once up front
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::generate(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask)
+{
+	if (m_regs.rhythm_enable())
+		generate_path<OUTPUT_RHYTHM, false>(output, numsamples, rshift, clipmax, chanmask, chanmask);
+	else
+		generate_path<OUTPUT_CHANNELS, false>(output, numsamples, rshift, clipmax, chanmask, chanmask);
+}
+
+
+//-------------------------------------------------
+//  generate_channels - clock a block of samples
+//  like generate(), but compute the output of
+//  each channel in outmask separately, so that
+//  each can be processed before mixing; output
+//  holds CHANNELS entries per sample, and those
+//  for channels not computed are cleared; rhythm
+//  mode is not supported
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::generate_channels(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask)
+{
+	assert(!m_regs.rhythm_enable());
+	generate_path<OUTPUT_CHANNELS, true>(output, numsamples, rshift, clipmax, chanmask, outmask);
+}
+
+
+//-------------------------------------------------
+//  generate_path - clock and compute the outputs
+//  for a block of samples with the output path
+//  fixed at compile time
+//-------------------------------------------------
+
+template<class RegisterType>
+template<output_path Path, bool Split>
+void fm_engine_base<RegisterType>::generate_path(output_data *output, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask)
+{
+	// each sample has one output, or one per channel if split
+	static constexpr uint32_t STRIDE = Split ? CHANNELS : 1;
+
+	// writes since the last block or a new channel mask force a prepare
+	// on the first sample; after that only a CSM key on being released
+	// prepares again, and only operators going quiet change the active
+	// channels
+	bool pending = (m_prepare_pending || chanmask != m_prepared_chanmask);
+
+	// mask out some channels for debug purposes; inactive channels are
+	// masked below, whenever the active set is recomputed
+	uint32_t const debugmask = outmask & debug::GLOBAL_FM_CHANNEL_MASK;
+	uint32_t mask = DEBUG_LOG_WAVFILES ? debugmask : (debugmask & m_active_channels);
+
+	for (uint32_t samp = 0; samp < numsamples; samp++, output += STRIDE)
 	{
-		// reassign operators to channels if dynamic
-		if (RegisterType::DYNAMIC_OPS)
-			assign_operators();
+		// with nothing active, skip ahead over the clocks where nothing
+		// can change and just produce silence
+		uint32_t silent = std::min(silent_horizon(chanmask), numsamples - samp);
+		if (silent != 0)
+		{
+			clock_silent(chanmask, silent);
+			for (uint32_t index = 0; index < silent * STRIDE; index++)
+				output[index].clear();
+			samp += silent - 1;
+			output += (silent - 1) * STRIDE;
+			continue;
+		}
 
-		// call each channel to prepare
-		m_active_channels = 0;
-		for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
-			if (bitfield(chanmask, chnum))
-				if (m_channel[chnum]->prepare())
-					m_active_channels |= 1 << chnum;
+		// update the clock counter and prepare if needed
+		m_total_clocks++;
+		if (pending || m_activity_pending)
+		{
+			if (pending)
+				prepare(chanmask);
+			else
+				update_activity();
+			pending = m_prepare_pending;
+			if (!DEBUG_LOG_WAVFILES)
+				mask = debugmask & m_active_channels;
+		}
+
+		// where only the phases change for a while, compute the operator
+		// stages across a block of samples at a time
+		if (Path != OUTPUT_RHYTHM)
+		{
+			uint32_t block = std::min({ block_horizon(mask), numsamples - samp, BLOCK_SAMPLES });
+			if (block >= 4)
+			{
+				generate_block(output, Split, block, rshift, clipmax, chanmask, mask);
+				m_total_clocks += block - 1;
+				samp += block - 1;
+				output += (block - 1) * STRIDE;
+				continue;
+			}
+		}
+
+		// advance the state
+		clock_state(chanmask);
+
+		// compute the outputs
+		for (uint32_t index = 0; index < STRIDE; index++)
+			output[index].clear();
+		if (Path == OUTPUT_RHYTHM)
+			output_rhythm(*output, rshift, clipmax, mask);
+		else
+			output_channels(output, Split, rshift, clipmax, mask);
+	}
+}
+
+
+//-------------------------------------------------
+//  update_feedback - update the only state that
+//  output() updates, which is the operator 1
+//  feedback of each channel; if all is false,
+//  channels without feedback are skipped
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::update_feedback(uint32_t chanmask, bool all) const
+{
+	// mask out the same channels output() does
+	chanmask &= debug::GLOBAL_FM_CHANNEL_MASK;
+	if (!DEBUG_LOG_WAVFILES)
+		chanmask &= m_active_channels;
+
+	// the rhythm mode cymbal/hi-hat channels don't use feedback
+	if (m_regs.rhythm_enable())
+		chanmask &= ~(3 << 7);
+
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+			if (all || m_regs.ch_feedback(m_channel[chnum].choffs()) != 0)
+				m_channel[chnum].output_feedback();
+}
 
-		// reset the modified channels and prepare count
-		m_modified_channels = m_prepare_count = 0;
+
+//-------------------------------------------------
+//  advance - clock a block of samples, leaving
+//  the state exactly as generate() would, but
+//  computing only what feeds forward from the
+//  outputs
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::advance(uint32_t numsamples, uint32_t chanmask, uint32_t outmask)
+{
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		// skip ahead over silence, as generate() does
+		uint32_t silent = std::min(silent_horizon(chanmask), numsamples - samp);
+		if (silent != 0)
+		{
+			clock_silent(chanmask, silent);
+			samp += silent - 1;
+			continue;
+		}
+
+		// clock the state
+		clock(chanmask);
+
+		// operator 1 without feedback only matters once it lands in the
+		// feedback history, so it is only needed over the final samples and
+		// just before a channel can be deactivated, after which the history
+		// holds the last value computed
+		update_feedback(outmask, numsamples - samp <= 3 || m_activity_pending);
 	}
+}
+
+
+//-------------------------------------------------
+//  prepare - prepare the requested channels and
+//  rebuild the derived state used for clocking
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::prepare(uint32_t chanmask)
+{
+	// reassign operators to channels if dynamic; the mapping only depends
+	// on the 4-operator enables
+	if (RegisterType::DYNAMIC_OPS && m_regs.fourop_enable() != m_op_map_fourop)
+		assign_operators();
+
+	// a new channel mask refreshes everything; otherwise only channels
+	// whose registers changed are re-cached
+	uint32_t modified = m_modified_channels;
+	if (chanmask != m_prepared_chanmask)
+		modified = ALL_CHANNELS;
+
+	// operators not on a prepared channel don't advance their phase
+	if (modified == ALL_CHANNELS)
+		std::fill_n(&m_op_phase_step[0], OPERATORS, 0);
+
+	// call each channel to prepare; operators consuming a CSM key on ask
+	// for another prepare on the next clock
+	m_prepare_pending = false;
+	m_active_channels = 0;
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+			if (m_channel[chnum].prepare(bitfield(modified, chnum) != 0))
+				m_active_channels |= 1 << chnum;
+
+	// rebuild the lists of operators to clock; the dynamic phase steps
+	// have to be recomputed against the new cached data
+	build_clock_lists(chanmask);
+	m_dynamic_valid = false;
+
+	// reset the modified channels; activity is now up to date
+	m_modified_channels = 0;
+	m_activity_pending = false;
+	m_prepared_chanmask = chanmask;
+}
+
+
+//-------------------------------------------------
+//  update_activity - drop channels whose operators
+//  have all gone quiet after the release from the
+//  active set; a channel can only become active
+//  again on a key on, which prepares it
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::update_activity()
+{
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(m_active_channels, chnum))
+			if (!m_channel[chnum].update_activity())
+				m_active_channels &= ~(1 << chnum);
+	m_activity_pending = false;
+}
 
+
+//-------------------------------------------------
+//  clock_state - advance the envelope counter,
+//  LFO, channels, and operators by one sample
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_engine_base<RegisterType>::clock_state(uint32_t chanmask)
+{
 	// if the envelope clock divider is 1, just increment by 4;
 	// otherwise, increment by 1 and manually wrap when we reach the divide count
 	if (RegisterType::EG_CLOCK_DIVIDER == 1)
@@ -1310,83 +2016,261 @@ uint32_t fm_engine_base<RegisterType>::clock(uint32_t chanmask)
 	// clock the noise generator
 	int32_t lfo_raw_pm = m_regs.clock_noise_and_lfo();
 
-	// now update the state of all the channels and operators
+	// now update the state of all the channels
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			m_channel[chnum]->clock(m_env_counter, lfo_raw_pm);
+			m_channel[chnum].clock();
+
+	// clock the SSG-EG and envelope state of the operators
+	for (uint32_t index = 0; index < m_clock_op_count; index++)
+		m_operator[m_clock_ops[index]].clock(m_env_counter);
+
+	// compute the phase step for operators affected by the PM LFO
+	update_dynamic_steps(lfo_raw_pm);
 
-	// return the envelope counter as it is used to clock ADPCM-A
+	// advance all phases in one pass; unclocked operators have a step of 0
+	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
+		m_op_phase[opnum] += m_op_phase_step[opnum];
 	return m_env_counter;
 }
 
 
 //-------------------------------------------------
-//  output - compute a sum over the relevant
-//  channels
+//  silent_horizon - return the number of upcoming
+//  clocks that clock_silent can cover: none if
+//  any channel is active or a prepare is due,
+//  otherwise up to the next envelope change
 //-------------------------------------------------
 
 template<class RegisterType>
-void fm_engine_base<RegisterType>::output(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const
+uint32_t fm_engine_base<RegisterType>::silent_horizon(uint32_t chanmask) const
 {
-	// mask out some channels for debug purposes
-	chanmask &= debug::GLOBAL_FM_CHANNEL_MASK;
+	if (DEBUG_LOG_WAVFILES || m_active_channels != 0 || m_prepare_pending || chanmask != m_prepared_chanmask)
+		return 0;
+	return envelope_horizon();
+}
 
-	// mask out inactive channels
-	if (!DEBUG_LOG_WAVFILES)
-		chanmask &= m_active_channels;
 
-	// handle the rhythm case, where some of the operators are dedicated
-	// to percussion (this is an OPL-specific feature)
-	if (m_regs.rhythm_enable())
+//-------------------------------------------------
+//  clock_silent - advance the state by the given
+//  number of clocks, within the silent horizon;
+//  equivalent to calling clock_state() for each,
+//  but no envelope can change, so the operators
+//  only need their phases advanced
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_engine_base<RegisterType>::clock_silent(uint32_t chanmask, uint32_t count)
+{
+	// account for the clocks skipped
+	m_total_clocks += count;
+
+	// advance the envelope counter
+	clock_env_counter(count);
+
+	// the channel feedback settles after two clocks
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+			for (uint32_t index = 0; index < std::min<uint32_t>(count, 2); index++)
+				m_channel[chnum].clock();
+
+	// fixed phase steps advance all at once; steps affected by the PM LFO
+	// are updated every clock below
+	for (uint32_t index = 0; index < m_dynamic_op_count; index++)
+		m_op_phase_step[m_dynamic_ops[index]] = 0;
+	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
+		m_op_phase[opnum] += m_op_phase_step[opnum] * count;
+	m_dynamic_valid = false;
+
+	// the noise and LFO have to be clocked one at a time
+	for (uint32_t clock = 0; clock < count; clock++)
 	{
-		// we don't support the OPM noise channel here; ensure it is off
-		assert(m_regs.noise_enable() == 0);
+		update_dynamic_steps(m_regs.clock_noise_and_lfo());
+		for (uint32_t index = 0; index < m_dynamic_op_count; index++)
+		{
+			uint32_t opnum = m_dynamic_ops[index];
+			m_op_phase[opnum] += m_op_phase_step[opnum];
+		}
+	}
+	return m_env_counter;
+}
+
+
+//-------------------------------------------------
+//  clock_env_counter - advance the envelope
+//  counter by the given number of clocks; with a
+//  clock divider, the low 2 bits count up to the
+//  divider before carrying into the upper bits
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::clock_env_counter(uint32_t count)
+{
+	if (RegisterType::EG_CLOCK_DIVIDER == 1)
+		m_env_counter += 4 * count;
+	else
+	{
+		uint32_t sub = bitfield(m_env_counter, 0, 2) + count;
+		m_env_counter = (m_env_counter & ~3) + 4 * (sub / RegisterType::EG_CLOCK_DIVIDER) + sub % RegisterType::EG_CLOCK_DIVIDER;
+	}
+}
+
+
+//-------------------------------------------------
+//  block_horizon - return the number of upcoming
+//  clocks that generate_block can cover: none if
+//  a phase step can change (PM LFO), the OPM
+//  noise is output, or a prepare or activity
+//  update is due, otherwise up to the next
+//  envelope change
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_engine_base<RegisterType>::block_horizon(uint32_t outmask) const
+{
+	if (DEBUG_LOG_WAVFILES || m_dynamic_op_count != 0 || m_prepare_pending || m_activity_pending)
+		return 0;
+	if (m_regs.noise_enable() && bitfield(outmask, 7))
+		return 0;
+	return envelope_horizon();
+}
+
 
-		// precompute the operator 13+17 phase selection value
-		uint32_t op13phase = m_operator[13]->phase();
-		uint32_t op17phase = m_operator[17]->phase();
-		uint32_t phase_select = (bitfield(op13phase, 2) ^ bitfield(op13phase, 7)) | bitfield(op13phase, 3) | (bitfield(op17phase, 5) ^ bitfield(op17phase, 3));
+//-------------------------------------------------
+//  generate_block - clock and compute the outputs
+//  for a block of samples within the block
+//  horizon; equivalent to calling clock_state()
+//  and computing the outputs for each, but since
+//  the envelopes and phase steps are fixed, the
+//  operators only need their phases advanced, and
+//  the channels compute each operator stage over
+//  all the samples at once
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::generate_block(output_data *output, bool split, uint32_t count, uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask)
+{
+	static uint32_t const s_no_am_offset[BLOCK_SAMPLES] = { 0 };
+
+	// advance the envelope counter
+	clock_env_counter(count);
 
-		// sum over all the desired channels
+	// the noise and LFO have to be clocked one at a time; record the AM
+	// offset of each output channel that uses it along the way
+	uint32_t am_offset[CHANNELS][BLOCK_SAMPLES];
+	uint32_t ammask = 0;
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(outmask, chnum) && m_channel[chnum].m_cache.lfo_am_enable)
+			ammask |= 1 << chnum;
+	for (uint32_t samp = 0; samp < count; samp++)
+	{
+		update_dynamic_steps(m_regs.clock_noise_and_lfo());
 		for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
-			if (bitfield(chanmask, chnum))
-			{
+			if (bitfield(ammask, chnum))
+				am_offset[chnum][samp] = m_channel[chnum].lfo_am_offset();
+	}
+
+	// compute the output channels, which clock their own feedback; the
+	// feedback of the others settles after two clocks
+	uint32_t const stride = split ? CHANNELS : 1;
+	for (uint32_t index = 0; index < count * stride; index++)
+		output[index].clear();
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(outmask, chnum))
+			m_channel[chnum].output_block(split ? &output[chnum] : output, stride, count, bitfield(ammask, chnum) ? am_offset[chnum] : s_no_am_offset, rshift, clipmax);
+		else if (bitfield(chanmask, chnum))
+			for (uint32_t index = 0; index < std::min<uint32_t>(count, 2); index++)
+				m_channel[chnum].clock();
+
+	// advance all phases at once; unclocked operators have a step of 0
+	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
+		m_op_phase[opnum] += m_op_phase_step[opnum] * count;
+}
+
+
+//-------------------------------------------------
+//  update_dynamic_steps - compute the phase step
+//  of operators affected by the PM LFO; these
+//  depend only on the raw PM value and on cached
+//  data that changes only in prepare(), so they
+//  are recomputed only when the PM value moves
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::update_dynamic_steps(int32_t lfo_raw_pm)
+{
+	if (!RegisterType::PHASE_STEP_STATEFUL && m_dynamic_valid && lfo_raw_pm == m_dynamic_pm)
+		return;
+	m_dynamic_pm = lfo_raw_pm;
+	m_dynamic_valid = true;
+	for (uint32_t index = 0; index < m_dynamic_op_count; index++)
+	{
+		uint32_t opnum = m_dynamic_ops[index];
+		m_op_phase_step[opnum] = m_operator[opnum].compute_phase_step(lfo_raw_pm);
+	}
+}
+
+
+//-------------------------------------------------
+//  output_rhythm - compute a sum over the given
+//  channels with OPL rhythm mode enabled
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::output_rhythm(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const
+{
+	// we don't support the OPM noise channel here; ensure it is off
+	assert(m_regs.noise_enable() == 0);
+
+	// precompute the operator 13+17 phase selection value
+	uint32_t op13phase = m_operator[13].phase();
+	uint32_t op17phase = m_operator[17].phase();
+	uint32_t phase_select = (bitfield(op13phase, 2) ^ bitfield(op13phase, 7)) | bitfield(op13phase, 3) | (bitfield(op17phase, 5) ^ bitfield(op17phase, 3));
+
+	// sum over all the desired channels
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+		{
 #if (DEBUG_LOG_WAVFILES)
-				auto reference = output;
+			auto reference = output;
 #endif
-				if (chnum == 6)
-					m_channel[chnum]->output_rhythm_ch6(output, rshift, clipmax);
-				else if (chnum == 7)
-					m_channel[chnum]->output_rhythm_ch7(phase_select, output, rshift, clipmax);
-				else if (chnum == 8)
-					m_channel[chnum]->output_rhythm_ch8(phase_select, output, rshift, clipmax);
-				else if (m_channel[chnum]->is4op())
-					m_channel[chnum]->output_4op(output, rshift, clipmax);
-				else
-					m_channel[chnum]->output_2op(output, rshift, clipmax);
+			if (chnum == 6)
+				m_channel[chnum].output_rhythm_ch6(output, rshift, clipmax);
+			else if (chnum == 7)
+				m_channel[chnum].output_rhythm_ch7(phase_select, output, rshift, clipmax);
+			else if (chnum == 8)
+				m_channel[chnum].output_rhythm_ch8(phase_select, output, rshift, clipmax);
+			else
+				m_channel[chnum].output(output, rshift, clipmax);
 #if (DEBUG_LOG_WAVFILES)
-				m_wavfile[chnum].add(output, reference);
+			m_wavfile[chnum].add(output, reference);
 #endif
-			}
-	}
-	else
-	{
-		// sum over all the desired channels
-		for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
-			if (bitfield(chanmask, chnum))
-			{
+		}
+}
+
+
+//-------------------------------------------------
+//  output_channels - compute a sum over the given
+//  channels, one channel at a time, or if split,
+//  each into its own output
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::output_channels(output_data *output, bool split, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const
+{
+	// sum over all the desired channels
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+		{
+			output_data &dest = split ? output[chnum] : output[0];
 #if (DEBUG_LOG_WAVFILES)
-				auto reference = output;
+			auto reference = dest;
 #endif
-				if (m_channel[chnum]->is4op())
-					m_channel[chnum]->output_4op(output, rshift, clipmax);
-				else
-					m_channel[chnum]->output_2op(output, rshift, clipmax);
+			m_channel[chnum].output(dest, rshift, clipmax);
 #if (DEBUG_LOG_WAVFILES)
-				m_wavfile[chnum].add(output, reference);
+			m_wavfile[chnum].add(dest, reference);
 #endif
-			}
-	}
+		}
 }
 
 
@@ -1407,31 +2291,68 @@ void fm_engine_base<RegisterType>::write(uint16_t regnum, uint8_t data)
 		return;
 	}
 
-	// for now just mark all channels as modified
-	m_modified_channels = ALL_CHANNELS;
-
-	// most writes are passive, consumed only when needed
+	// most writes are passive, consumed only when needed; note which
+	// channels need their cached data refreshed, and prepare on the next
+	// clock regardless so that any key state changes are picked up
 	uint32_t keyon_channel;
 	uint32_t keyon_opmask;
-	if (m_regs.write(regnum, data, keyon_channel, keyon_opmask))
+	uint32_t modified;
+	bool keyon = m_regs.write(regnum, data, keyon_channel, keyon_opmask, modified);
+	m_modified_channels |= modified;
+	m_prepare_pending = true;
+	if (keyon)
 	{
 		// handle writes to the keyon register(s)
 		if (keyon_channel < CHANNELS)
 		{
 			// normal channel on/off
-			m_channel[keyon_channel]->keyonoff(keyon_opmask, KEYON_NORMAL, keyon_channel);
+			m_channel[keyon_channel].keyonoff(keyon_opmask, KEYON_NORMAL, keyon_channel);
 		}
 		else if (CHANNELS >= 9 && keyon_channel == RegisterType::RHYTHM_CHANNEL)
 		{
 			// special case for the OPL rhythm channels
-			m_channel[6]->keyonoff(bitfield(keyon_opmask, 4) ? 3 : 0, KEYON_RHYTHM, 6);
-			m_channel[7]->keyonoff(bitfield(keyon_opmask, 0) | (bitfield(keyon_opmask, 3) << 1), KEYON_RHYTHM, 7);
-			m_channel[8]->keyonoff(bitfield(keyon_opmask, 2) | (bitfield(keyon_opmask, 1) << 1), KEYON_RHYTHM, 8);
+			m_channel[6].keyonoff(bitfield(keyon_opmask, 4) ? 3 : 0, KEYON_RHYTHM, 6);
+			m_channel[7].keyonoff(bitfield(keyon_opmask, 0) | (bitfield(keyon_opmask, 3) << 1), KEYON_RHYTHM, 7);
+			m_channel[8].keyonoff(bitfield(keyon_opmask, 2) | (bitfield(keyon_opmask, 1) << 1), KEYON_RHYTHM, 8);
 		}
 	}
 }
 
 
+//-------------------------------------------------
+//  envelope_horizon - return the number of
+//  upcoming clocks over which the envelopes of
+//  all clocked operators are guaranteed not to
+//  change, barring register writes or a prepare
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_engine_base<RegisterType>::envelope_horizon() const
+{
+	// envelope cycles happen when the low 2 bits of the counter are 0; in
+	// between, the counter steps through EG_CLOCK_DIVIDER sub-counts
+	uint32_t base = m_env_counter & ~3;
+	uint32_t first = RegisterType::EG_CLOCK_DIVIDER - bitfield(m_env_counter, 0, 2);
+
+	uint32_t result = ~0;
+	for (uint32_t index = 0; index < m_clock_op_count; index++)
+	{
+		auto &op = m_operator[m_clock_ops[index]];
+
+		// SSG-EG can change the attenuation on any clock
+		if (RegisterType::EG_HAS_SSG && op.ssg_eg_enable())
+			return 0;
+
+		// count the envelope cycles before the event; events in the past
+		// happen on the next envelope cycle
+		uint32_t delta = op.env_next() - base;
+		uint32_t cycles = (int32_t(delta) > 4) ? (delta >> 2) - 1 : 0;
+		result = std::min(result, first + cycles * RegisterType::EG_CLOCK_DIVIDER - 1);
+	}
+	return result;
+}
+
+
 //-------------------------------------------------
 //  status - return the current state of the
 //  status flags
@@ -1452,14 +2373,48 @@ uint8_t fm_engine_base<RegisterType>::status() const
 template<class RegisterType>
 void fm_engine_base<RegisterType>::assign_operators()
 {
-	typename RegisterType::operator_mapping map;
-	m_regs.operator_map(map);
+	m_regs.operator_map(m_op_map);
+	m_op_map_fourop = m_regs.fourop_enable();
 
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
 		for (uint32_t index = 0; index < 4; index++)
 		{
-			uint32_t opnum = bitfield(map.chan[chnum], 8 * index, 8);
-			m_channel[chnum]->assign(index, (opnum == 0xff) ? nullptr : m_operator[opnum].get());
+			uint32_t opnum = bitfield(m_op_map.chan[chnum], 8 * index, 8);
+			m_channel[chnum].assign(index, (opnum == 0xff) ? nullptr : &m_operator[opnum]);
+		}
+}
+
+
+//-------------------------------------------------
+//  build_clock_lists - build the lists of
+//  operators clocked each sample, and those whose
+//  phase step must be recomputed each sample
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::build_clock_lists(uint32_t chanmask)
+{
+	static_assert(OPERATORS <= 64, "Operator mask must fit in 64 bits");
+
+	// gather the operators assigned to the requested channels
+	uint64_t opmask = 0;
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+			for (uint32_t index = 0; index < 4; index++)
+			{
+				uint32_t opnum = bitfield(m_op_map.chan[chnum], 8 * index, 8);
+				if (opnum != 0xff)
+					opmask |= uint64_t(1) << opnum;
+			}
+
+	// walk them in order, noting which need dynamic phase steps
+	m_clock_op_count = m_dynamic_op_count = 0;
+	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
+		if (((opmask >> opnum) & 1) != 0)
+		{
+			m_clock_ops[m_clock_op_count++] = opnum;
+			if (m_operator[opnum].phase_step_dynamic())
+				m_dynamic_ops[m_dynamic_op_count++] = opnum;
 		}
 }
 
@@ -1514,8 +2469,8 @@ void fm_engine_base<RegisterType>::engine_timer_expired(uint32_t tnum)
 		for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
 			if (bitfield(RegisterType::CSM_TRIGGER_MASK, chnum))
 			{
-				m_channel[chnum]->keyonoff(1, KEYON_CSM, chnum);
-				m_modified_channels |= 1 << chnum;
+				m_channel[chnum].keyonoff(1, KEYON_CSM, chnum);
+				m_prepare_pending = true;
 			}
 
 	// reset
@@ -1556,12 +2511,11 @@ void fm_engine_base<RegisterType>::engine_check_interrupts()
 template<class RegisterType>
 void fm_engine_base<RegisterType>::engine_mode_write(uint8_t data)
 {
-	// mark all channels as modified
-	m_modified_channels = ALL_CHANNELS;
-
-	// actually write the mode register now
-	uint32_t dummy1, dummy2;
-	m_regs.write(RegisterType::REG_MODE, data, dummy1, dummy2);
+	// actually write the mode register now, noting any channels affected
+	uint32_t dummy1, dummy2, modified;
+	m_regs.write(RegisterType::REG_MODE, data, dummy1, dummy2, modified);
+	m_modified_channels |= modified;
+	m_prepare_pending = true;
 
 	// reset IRQ status -- when written, all other bits are ignored
 	// QUESTION: should this maybe just reset the IRQ bit and not all the bits?
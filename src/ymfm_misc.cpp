@@ -162,14 +162,21 @@ void ym2149::write(uint32_t offset, uint8_t data)
 
 void ym2149::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the SSG
-		m_ssg.clock();
+	// YM2149 keeps the three SSG outputs independent, so the SSG can write
+	// them directly
+	m_ssg.generate(output, numsamples);
+}
 
-		// YM2149 keeps the three SSG outputs independent
-		m_ssg.output(*output);
-	}
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2149::advance(uint32_t numsamples)
+{
+	// the SSG state can be advanced without computing any output
+	m_ssg.advance(numsamples);
 }
 
 }
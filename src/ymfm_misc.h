@@ -82,6 +82,13 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// direct access to the SSG, for rendering it with ssg_blep at a rate
+	// other than sample_rate()
+	ssg_engine &ssg() { return m_ssg; }
+
 protected:
 	// internal state
 	uint8_t m_address;               // address register
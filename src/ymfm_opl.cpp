@@ -66,18 +66,30 @@ opl_registers_base<Revision>::opl_registers_base() :
 	m_lfo_am_counter(0),
 	m_lfo_pm_counter(0),
 	m_noise_lfsr(1),
-	m_lfo_am(0)
+	m_lfo_am(0),
+	m_waveform(shared_tables().waveform)
+{
+}
+
+
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+template<int Revision>
+opl_registers_base<Revision>::waveform_tables::waveform_tables()
 {
 	// create these pointers to appease overzealous compilers checking array
 	// bounds in unreachable code (looking at you, clang)
-	uint16_t *wf0 = &m_waveform[0][0];
-	uint16_t *wf1 = &m_waveform[1 % WAVEFORMS][0];
-	uint16_t *wf2 = &m_waveform[2 % WAVEFORMS][0];
-	uint16_t *wf3 = &m_waveform[3 % WAVEFORMS][0];
-	uint16_t *wf4 = &m_waveform[4 % WAVEFORMS][0];
-	uint16_t *wf5 = &m_waveform[5 % WAVEFORMS][0];
-	uint16_t *wf6 = &m_waveform[6 % WAVEFORMS][0];
-	uint16_t *wf7 = &m_waveform[7 % WAVEFORMS][0];
+	uint16_t *wf0 = &waveform[0][0];
+	uint16_t *wf1 = &waveform[1 % WAVEFORMS][0];
+	uint16_t *wf2 = &waveform[2 % WAVEFORMS][0];
+	uint16_t *wf3 = &waveform[3 % WAVEFORMS][0];
+	uint16_t *wf4 = &waveform[4 % WAVEFORMS][0];
+	uint16_t *wf5 = &waveform[5 % WAVEFORMS][0];
+	uint16_t *wf6 = &waveform[6 % WAVEFORMS][0];
+	uint16_t *wf7 = &waveform[7 % WAVEFORMS][0];
 
 	// create the waveforms
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
@@ -103,6 +115,19 @@ opl_registers_base<Revision>::opl_registers_base() :
 }
 
 
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+template<int Revision>
+typename opl_registers_base<Revision>::waveform_tables const &opl_registers_base<Revision>::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
+}
+
+
 //-------------------------------------------------
 //  reset - reset to initial state
 //-------------------------------------------------
@@ -183,19 +208,25 @@ void opl_registers_base<Revision>::operator_map(operator_mapping &dest) const
 
 
 //-------------------------------------------------
-//  write - handle writes to the register array
+//  write - handle writes to the register array;
+//  modified is set to the mask of channels whose
+//  cached data may have changed as a result
 //-------------------------------------------------
 
 template<int Revision>
-bool opl_registers_base<Revision>::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opl_registers_base<Revision>::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
 	assert(index < REGISTERS);
+	modified = 0;
 
 	// writes to the mode register with high bit set ignore the low bits
 	if (index == REG_MODE && bitfield(data, 7) != 0)
 		m_regdata[index] |= 0x80;
-	else
+	else if (m_regdata[index] != data)
+	{
+		modified = modified_channels(index, data);
 		m_regdata[index] = data;
+	}
 
 	// handle writes to the rhythm keyons
 	if (index == 0xbd)
@@ -221,6 +252,56 @@ bool opl_registers_base<Revision>::write(uint16_t index, uint8_t data, uint32_t
 }
 
 
+//-------------------------------------------------
+//  modified_channels - return the mask of channels
+//  whose cached data depends on the given register,
+//  which is about to change to the given value
+//-------------------------------------------------
+
+template<int Revision>
+uint32_t opl_registers_base<Revision>::modified_channels(uint16_t index, uint8_t data) const
+{
+	uint32_t reg = index & 0xff;
+	uint32_t bank = IsOpl3Plus ? bitfield(index, 8) : 0;
+	uint32_t chnum;
+
+	// per-channel registers
+	if (reg >= 0xa0 && reg < 0xd0 && reg != 0xbd)
+	{
+		chnum = reg & 0x0f;
+		if (chnum >= 9)
+			return 0;
+	}
+
+	// per-operator registers; each group of 8 has 6 valid operators
+	else if ((reg >= 0x20 && reg < 0xa0) || reg >= 0xe0)
+	{
+		uint32_t opoffs = reg & 0x1f;
+		if (bitfield(opoffs, 0, 3) >= 6 || bitfield(opoffs, 3, 2) >= 3)
+			return 0;
+		chnum = bitfield(opoffs, 0, 3) % 3 + 3 * bitfield(opoffs, 3, 2);
+	}
+
+	// toggling rhythm mode changes how channels 6-8 are generated
+	else if (reg == 0xbd)
+		return (bitfield(m_regdata[index] ^ data, 5) != 0) ? (7 << 6) : 0;
+
+	// waveform enable, note select, 4-op and OPL3 mode selection are global
+	else if (index == 0x01 || index == 0x08 || index == 0x104 || index == 0x105)
+		return ALL_CHANNELS;
+	else
+		return 0;
+
+	// channels 3-5 in each bank can be the second half of a 4-operator
+	// channel owned by channels 0-2
+	chnum += 9 * bank;
+	uint32_t result = 1 << chnum;
+	if (IsOpl3Plus && chnum % 9 >= 3 && chnum % 9 < 6)
+		result |= 1 << (chnum - 3);
+	return result;
+}
+
+
 //-------------------------------------------------
 //  clock_noise_and_lfo - clock the noise and LFO,
 //  handling clock division, depth, and waveform
@@ -437,16 +518,9 @@ opll_registers::opll_registers() :
 	m_lfo_am_counter(0),
 	m_lfo_pm_counter(0),
 	m_noise_lfsr(1),
-	m_lfo_am(0)
+	m_lfo_am(0),
+	m_waveform(shared_tables().waveform)
 {
-	// create the waveforms
-	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
-
-	uint16_t zeroval = m_waveform[0][0];
-	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[1][index] = bitfield(index, 9) ? zeroval : m_waveform[0][index];
-
 	// initialize the instruments to something sane
 	for (uint32_t choffs = 0; choffs < CHANNELS; choffs++)
 		m_chinst[choffs] = &m_regdata[0];
@@ -455,6 +529,35 @@ opll_registers::opll_registers() :
 }
 
 
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+opll_registers::waveform_tables::waveform_tables()
+{
+	// create the waveforms
+	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
+		waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+
+	uint16_t zeroval = waveform[0][0];
+	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
+		waveform[1][index] = bitfield(index, 9) ? zeroval : waveform[0][index];
+}
+
+
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+opll_registers::waveform_tables const &opll_registers::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
+}
+
+
 //-------------------------------------------------
 //  reset - reset to initial state
 //-------------------------------------------------
@@ -509,15 +612,21 @@ void opll_registers::operator_map(operator_mapping &dest) const
 //  channels cleanly
 //-------------------------------------------------
 
-bool opll_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opll_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
+	modified = 0;
+
 	// unclear the address is masked down to 6 bits or if writes above
 	// the register top are ignored; assuming the latter for now
 	if (index >= REGISTERS)
 		return false;
 
-	// write the new data
-	m_regdata[index] = data;
+	// write the new data, noting which channels are affected
+	if (m_regdata[index] != data)
+	{
+		modified = modified_channels(index, data);
+		m_regdata[index] = data;
+	}
 
 	// handle writes to the rhythm keyons
 	if (index == 0x0e)
@@ -541,6 +650,39 @@ bool opll_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint
 }
 
 
+//-------------------------------------------------
+//  modified_channels - return the mask of channels
+//  whose cached data depends on the given register,
+//  which is about to change to the given value
+//-------------------------------------------------
+
+uint32_t opll_registers::modified_channels(uint16_t index, uint8_t data) const
+{
+	// per-channel registers
+	if (index >= 0x10)
+	{
+		uint32_t chnum = index & 0x0f;
+		return (chnum < CHANNELS) ? (1 << chnum) : 0;
+	}
+
+	// toggling rhythm mode changes how channels 6-8 are generated
+	if (index == 0x0e)
+		return (bitfield(m_regdata[index] ^ data, 5) != 0) ? (7 << 6) : 0;
+
+	// the custom instrument affects every melodic channel that uses it
+	if (index < 0x08)
+	{
+		uint32_t result = 0;
+		uint32_t melodic = rhythm_enable() ? 6 : CHANNELS;
+		for (uint32_t chnum = 0; chnum < melodic; chnum++)
+			if (ch_instrument(chnum) == 0)
+				result |= 1 << chnum;
+		return result;
+	}
+	return 0;
+}
+
+
 //-------------------------------------------------
 //  clock_noise_and_lfo - clock the noise and LFO,
 //  handling clock division, depth, and waveform
@@ -843,18 +985,24 @@ void ym3526::write(uint32_t offset, uint8_t data)
 
 void ym3526::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; mixing details for YM3526 need verification
+	m_fm.generate(output, numsamples, 1, 32767, fm_engine::ALL_CHANNELS);
+
+	// YM3526 uses an external DAC (YM3014) with mantissa/exponent format
+	// convert to 10.3 floating point value and back to simulate truncation
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->roundtrip_fp();
+}
 
-		// update the FM content; mixing details for YM3526 need verification
-		m_fm.output(output->clear(), 1, 32767, fm_engine::ALL_CHANNELS);
 
-		// YM3526 uses an external DAC (YM3014) with mantissa/exponent format
-		// convert to 10.3 floating point value and back to simulate truncation
-		output->roundtrip_fp();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym3526::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 
@@ -1077,15 +1225,14 @@ void y8950::write(uint32_t offset, uint8_t data)
 
 void y8950::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; clipping need verification
+	m_fm.generate(output, numsamples, 1, 32767, fm_engine::ALL_CHANNELS);
+
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		// clock the ADPCM
 		m_adpcm_b.clock();
 
-		// update the FM content; clipping need verification
-		m_fm.output(output->clear(), 1, 32767, fm_engine::ALL_CHANNELS);
-
 		// mix in the ADPCM; ADPCM-B is stereo, but only one channel
 		// not sure how it's wired up internally
 		m_adpcm_b.output(*output, 3);
@@ -1097,6 +1244,21 @@ void y8950::generate(output_data *output, uint32_t numsamples)
 }
 
 
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void y8950::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
+
+	// the ADPCM output doesn't affect its state
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+		m_adpcm_b.clock();
+}
+
+
 
 //*********************************************************
 //  YM3812
@@ -1223,18 +1385,24 @@ void ym3812::write(uint32_t offset, uint8_t data)
 
 void ym3812::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; mixing details for YM3812 need verification
+	m_fm.generate(output, numsamples, 1, 32767, fm_engine::ALL_CHANNELS);
+
+	// YM3812 uses an external DAC (YM3014) with mantissa/exponent format
+	// convert to 10.3 floating point value and back to simulate truncation
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->roundtrip_fp();
+}
 
-		// update the FM content; mixing details for YM3812 need verification
-		m_fm.output(output->clear(), 1, 32767, fm_engine::ALL_CHANNELS);
 
-		// YM3812 uses an external DAC (YM3014) with mantissa/exponent format
-		// convert to 10.3 floating point value and back to simulate truncation
-		output->roundtrip_fp();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym3812::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 
@@ -1396,17 +1564,23 @@ void ymf262::write(uint32_t offset, uint8_t data)
 
 void ymf262::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; mixing details for YMF262 need verification
+	m_fm.generate(output, numsamples, 0, 32767, fm_engine::ALL_CHANNELS);
+
+	// YMF262 output is 16-bit offset serial via YAC512 DAC
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->clamp16();
+}
 
-		// update the FM content; mixing details for YMF262 need verification
-		m_fm.output(output->clear(), 0, 32767, fm_engine::ALL_CHANNELS);
 
-		// YMF262 output is 16-bit offset serial via YAC512 DAC
-		output->clamp16();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ymf262::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 
@@ -1538,7 +1712,10 @@ void ymf289b::write_data(uint8_t data)
 
 	// writes to 0x108 with the CLR flag set clear the registers
 	if (m_address == 0x108 && bitfield(data, 2) != 0)
+	{
 		m_fm.regs().reset();
+		m_fm.invalidate_caches();
+	}
 
 	// count busy time
 	m_fm.intf().ymfm_set_busy_end(56);
@@ -1599,24 +1776,38 @@ void ymf289b::write(uint32_t offset, uint8_t data)
 
 void ymf289b::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	while (numsamples != 0)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
-
-		// update the FM content; mixing details for YMF262 need verification
-		fm_engine::output_data full;
-		m_fm.output(full.clear(), 0, 32767, fm_engine::ALL_CHANNELS);
+		// clock the system and update the FM content a chunk at a time;
+		// mixing details for YMF262 need verification
+		fm_engine::output_data full[32];
+		uint32_t const count = std::min<uint32_t>(numsamples, 32);
+		m_fm.generate(full, count, 0, 32767, fm_engine::ALL_CHANNELS);
 
 		// YMF278B output is 16-bit offset serial via YAC512 DAC, but
 		// only 2 of the 4 outputs are exposed
-		output->data[0] = full.data[0];
-		output->data[1] = full.data[1];
-		output->clamp16();
+		for (uint32_t samp = 0; samp < count; samp++, output++)
+		{
+			output->data[0] = full[samp].data[0];
+			output->data[1] = full[samp].data[1];
+			output->clamp16();
+		}
+		numsamples -= count;
 	}
 }
 
 
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ymf289b::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
+}
+
+
 
 //*********************************************************
 //  YMF278B
@@ -1886,41 +2077,81 @@ void ymf278b::generate(output_data *output, uint32_t numsamples)
 	int32_t const pcm_r = s_mix_scale[m_pcm.regs().mix_pcm_r()];
 	int32_t const fm_l = s_mix_scale[m_pcm.regs().mix_fm_l()];
 	int32_t const fm_r = s_mix_scale[m_pcm.regs().mix_fm_r()];
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	for (uint32_t remaining = numsamples; remaining != 0; )
 	{
-		// clock the system
-		m_fm_pos += FM_EXTRA_SAMPLE_STEP;
-		if (m_fm_pos >= FM_EXTRA_SAMPLE_THRESH)
+		// update the FM content a chunk at a time, in runs broken up by
+		// the extra FM clocks; mixing details for YMF278B need verification
+		fm_engine::output_data fmout[32];
+		uint32_t const count = std::min<uint32_t>(remaining, 32);
+		uint32_t start = 0;
+		for (uint32_t samp = 0; samp < count; samp++)
 		{
-			m_fm.clock(fm_engine::ALL_CHANNELS);
-			m_fm_pos -= FM_EXTRA_SAMPLE_THRESH;
+			m_fm_pos += FM_EXTRA_SAMPLE_STEP;
+			if (m_fm_pos >= FM_EXTRA_SAMPLE_THRESH)
+			{
+				m_fm.generate(&fmout[start], samp - start, 0, 32767, fm_engine::ALL_CHANNELS);
+				m_fm.clock(fm_engine::ALL_CHANNELS);
+				m_fm_pos -= FM_EXTRA_SAMPLE_THRESH;
+				start = samp;
+			}
 		}
-		m_fm.clock(fm_engine::ALL_CHANNELS);
-		m_pcm.clock(pcm_engine::ALL_CHANNELS);
+		m_fm.generate(&fmout[start], count - start, 0, 32767, fm_engine::ALL_CHANNELS);
 
-		// update the FM content; mixing details for YMF278B need verification
-		fm_engine::output_data fmout;
-		m_fm.output(fmout.clear(), 0, 32767, fm_engine::ALL_CHANNELS);
+		for (uint32_t samp = 0; samp < count; samp++, output++)
+		{
+			// clock and update the PCM content
+			pcm_engine::output_data pcmout;
+			m_pcm.clock(pcm_engine::ALL_CHANNELS);
+			m_pcm.output(pcmout.clear(), pcm_engine::ALL_CHANNELS);
 
-		// update the PCM content
-		pcm_engine::output_data pcmout;
-		m_pcm.output(pcmout.clear(), pcm_engine::ALL_CHANNELS);
+			// DO0 output: FM channels 2+3 only
+			output->data[0] = fmout[samp].data[2];
+			output->data[1] = fmout[samp].data[3];
 
-		// DO0 output: FM channels 2+3 only
-		output->data[0] = fmout.data[2];
-		output->data[1] = fmout.data[3];
+			// DO1 output: wavetable channels 2+3 only
+			output->data[2] = pcmout.data[2];
+			output->data[3] = pcmout.data[3];
 
-		// DO1 output: wavetable channels 2+3 only
-		output->data[2] = pcmout.data[2];
-		output->data[3] = pcmout.data[3];
+			// DO2 output: mixed FM channels 0+1 and wavetable channels 0+1
+			output->data[4] = (fmout[samp].data[0] * fm_l + pcmout.data[0] * pcm_l) >> 11;
+			output->data[5] = (fmout[samp].data[1] * fm_r + pcmout.data[1] * pcm_r) >> 11;
 
-		// DO2 output: mixed FM channels 0+1 and wavetable channels 0+1
-		output->data[4] = (fmout.data[0] * fm_l + pcmout.data[0] * pcm_l) >> 11;
-		output->data[5] = (fmout.data[1] * fm_r + pcmout.data[1] * pcm_r) >> 11;
+			// YMF278B output is 16-bit 2s complement serial
+			output->clamp16();
+		}
+		remaining -= count;
+	}
 
-		// YMF278B output is 16-bit 2s complement serial
-		output->clamp16();
+	// decrement the load waiting count
+	if (m_load_remaining > 0)
+		m_load_remaining -= std::min(m_load_remaining, numsamples);
+}
+
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ymf278b::advance(uint32_t numsamples)
+{
+	// advance the FM content in runs broken up by the extra FM clocks, as
+	// generate() does; the PCM output doesn't affect its state, so it only
+	// needs clocking
+	uint32_t start = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		m_fm_pos += FM_EXTRA_SAMPLE_STEP;
+		if (m_fm_pos >= FM_EXTRA_SAMPLE_THRESH)
+		{
+			m_fm.advance(samp - start, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
+			m_fm.clock(fm_engine::ALL_CHANNELS);
+			m_fm_pos -= FM_EXTRA_SAMPLE_THRESH;
+			start = samp;
+		}
+		m_pcm.clock(pcm_engine::ALL_CHANNELS);
 	}
+	m_fm.advance(numsamples - start, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 
 	// decrement the load waiting count
 	if (m_load_remaining > 0)
@@ -2025,14 +2256,11 @@ void opll_base::write(uint32_t offset, uint8_t data)
 
 void opll_base::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; OPLL has a built-in 9-bit DAC
+	m_fm.generate(output, numsamples, 5, 256, fm_engine::ALL_CHANNELS);
+
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
-
-		// update the FM content; OPLL has a built-in 9-bit DAC
-		m_fm.output(output->clear(), 5, 256, fm_engine::ALL_CHANNELS);
-
 		// final output is multiplexed; we don't simulate that here except
 		// to average over everything
 		output->data[0] = (output->data[0] * 128) / 9;
@@ -2041,6 +2269,17 @@ void opll_base::generate(output_data *output, uint32_t numsamples)
 }
 
 
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void opll_base::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
+}
+
+
 
 //*********************************************************
 //  YM2413
@@ -173,8 +173,8 @@ public:
 	// OPL4 apparently can read back FM registers?
 	uint8_t read(uint16_t index) const { return m_regdata[index]; }
 
-	// handle writes to the register array
-	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask);
+	// handle writes to the register array, noting which channels' cached data changed
+	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask, uint32_t &modified);
 
 	// clock the noise and LFO, if present, returning LFO PM value
 	int32_t clock_noise_and_lfo();
@@ -264,13 +264,24 @@ protected:
 		return rhythm_enable() && (choffs >= 6 && choffs <= 8);
 	}
 
+	// return the mask of channels affected by a change to a register
+	uint32_t modified_channels(uint16_t index, uint8_t data) const;
+
+	// tables shared by all instances, built on first use
+	struct waveform_tables
+	{
+		waveform_tables();
+		uint16_t waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	};
+	static waveform_tables const &shared_tables();
+
 	// internal state
 	uint16_t m_lfo_am_counter;            // LFO AM counter
 	uint16_t m_lfo_pm_counter;            // LFO PM counter
 	uint32_t m_noise_lfsr;                // noise LFSR state
 	uint8_t m_lfo_am;                     // current LFO AM value
 	uint8_t m_regdata[REGISTERS];         // register data
-	uint16_t m_waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	uint16_t const (*m_waveform)[WAVEFORM_LENGTH]; // waveforms (shared)
 };
 
 using opl_registers = opl_registers_base<1>;
@@ -379,8 +390,8 @@ public:
 	// read a register value
 	uint8_t read(uint16_t index) const { return m_regdata[index]; }
 
-	// handle writes to the register array
-	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask);
+	// handle writes to the register array, noting which channels' cached data changed
+	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask, uint32_t &modified);
 
 	// clock the noise and LFO, if present, returning LFO PM value
 	int32_t clock_noise_and_lfo();
@@ -477,6 +488,17 @@ private:
 		return rhythm_enable() && choffs >= 6;
 	}
 
+	// return the mask of channels affected by a change to a register
+	uint32_t modified_channels(uint16_t index, uint8_t data) const;
+
+	// tables shared by all instances, built on first use
+	struct waveform_tables
+	{
+		waveform_tables();
+		uint16_t waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	};
+	static waveform_tables const &shared_tables();
+
 	// internal state
 	uint16_t m_lfo_am_counter;            // LFO AM counter
 	uint16_t m_lfo_pm_counter;            // LFO PM counter
@@ -486,7 +508,7 @@ private:
 	uint8_t const *m_opinst[OPERATORS];   // pointer to instrument data for each operator
 	uint8_t m_regdata[REGISTERS];         // register data
 	uint8_t m_instdata[INSTDATA_SIZE];    // instrument data
-	uint16_t m_waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	uint16_t const (*m_waveform)[WAVEFORM_LENGTH]; // waveforms (shared)
 };
 
 
@@ -528,6 +550,9 @@ public:
 
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
+
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
 protected:
 	// internal state
 	uint8_t m_address;               // address register
@@ -575,6 +600,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	uint8_t m_address;               // address register
@@ -623,6 +651,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	uint8_t m_address;               // address register
@@ -670,6 +701,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	uint16_t m_address;              // address register
@@ -715,6 +749,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal helpers
 	bool ymf289b_mode() { return ((m_fm.regs().read(0x105) & 0x04) != 0); }
@@ -782,6 +819,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	uint16_t m_address;              // address register
@@ -811,7 +851,7 @@ public:
 	opll_base(ymfm_interface &intf, uint8_t const *data);
 
 	// configuration
-	void set_instrument_data(uint8_t const *data) { m_fm.regs().set_instrument_data(data); }
+	void set_instrument_data(uint8_t const *data) { m_fm.regs().set_instrument_data(data); m_fm.invalidate_caches(); }
 
 	// reset
 	void reset();
@@ -835,6 +875,9 @@ public:
 	// generate samples of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	uint8_t m_address;               // address register
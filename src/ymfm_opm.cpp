@@ -48,11 +48,25 @@ opm_registers::opm_registers() :
 	m_noise_counter(0),
 	m_noise_state(0),
 	m_noise_lfo(0),
-	m_lfo_am(0)
+	m_lfo_am(0),
+	m_lfo_waveform(shared_tables().lfo_waveform),
+	m_waveform(shared_tables().waveform)
+{
+	// LFO waveform 3 is noise and is filled in dynamically
+	std::fill_n(&m_lfo_noise[0], LFO_WAVEFORM_LENGTH, 0);
+}
+
+
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+opm_registers::waveform_tables::waveform_tables()
 {
 	// create the waveforms
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+		waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
 
 	// create the LFO waveforms; AM in the low 8 bits, PM in the upper 8
 	// waveforms are adjusted to match the pictures in the application manual
@@ -61,24 +75,33 @@ opm_registers::opm_registers() :
 		// waveform 0 is a sawtooth
 		uint8_t am = index ^ 0xff;
 		int8_t pm = int8_t(index);
-		m_lfo_waveform[0][index] = am | (pm << 8);
+		lfo_waveform[0][index] = am | (pm << 8);
 
 		// waveform 1 is a square wave
 		am = bitfield(index, 7) ? 0 : 0xff;
 		pm = int8_t(am ^ 0x80);
-		m_lfo_waveform[1][index] = am | (pm << 8);
+		lfo_waveform[1][index] = am | (pm << 8);
 
 		// waveform 2 is a triangle wave
 		am = bitfield(index, 7) ? (index << 1) : ((index ^ 0xff) << 1);
 		pm = int8_t(bitfield(index, 6) ? am : ~am);
-		m_lfo_waveform[2][index] = am | (pm << 8);
-
-		// waveform 3 is noise; it is filled in dynamically
-		m_lfo_waveform[3][index] = 0;
+		lfo_waveform[2][index] = am | (pm << 8);
 	}
 }
 
 
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+opm_registers::waveform_tables const &opm_registers::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
+}
+
+
 //-------------------------------------------------
 //  reset - reset to initial state
 //-------------------------------------------------
@@ -139,19 +162,39 @@ void opm_registers::operator_map(operator_mapping &dest) const
 
 
 //-------------------------------------------------
-//  write - handle writes to the register array
+//  write - handle writes to the register array;
+//  modified is set to the mask of channels whose
+//  cached data may have changed as a result
 //-------------------------------------------------
 
-bool opm_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opm_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
 	assert(index < REGISTERS);
+	modified = 0;
 
 	// LFO AM/PM depth are written to the same register (0x19);
 	// redirect the PM depth to an unused neighbor (0x1a)
+	uint32_t target = index;
 	if (index == 0x19)
-		m_regdata[index + bitfield(data, 7)] = data;
-	else if (index != 0x1a)
-		m_regdata[index] = data;
+		target = index + bitfield(data, 7);
+	else if (index == 0x1a)
+		return false;
+
+	if (m_regdata[target] != data)
+	{
+		// per-channel and per-operator registers affect their channel
+		if (target >= 0x20)
+			modified = 1 << bitfield(target, 0, 3);
+
+		// PM depth determines whether phase steps are dynamic
+		else if (target == 0x1a)
+			modified = ALL_CHANNELS;
+
+		// noise enable changes how channel 7 is generated
+		else if (target == 0x0f && bitfield(m_regdata[target] ^ data, 7) != 0)
+			modified = 1 << 7;
+	}
+	m_regdata[target] = data;
 
 	// handle writes to the key on index
 	if (index == 0x08)
@@ -210,12 +253,13 @@ int32_t opm_registers::clock_noise_and_lfo()
 	// ensures the current value remains stable for a full LFO clock
 	// and effectively latches the running value when the LFO advances
 	uint32_t lfo_noise = bitfield(m_noise_lfsr, 17, 8);
-	m_lfo_waveform[3][(lfo + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
+	m_lfo_noise[(lfo + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
 
 	// fetch the AM/PM values based on the waveform; AM is unsigned and
 	// encoded in the low 8 bits, while PM signed and encoded in the upper
-	// 8 bits
-	int32_t ampm = m_lfo_waveform[lfo_waveform()][lfo];
+	// 8 bits; waveform 3 is the noise
+	uint32_t waveform = lfo_waveform();
+	int32_t ampm = (waveform == 3) ? m_lfo_noise[lfo] : m_lfo_waveform[waveform][lfo];
 
 	// apply depth to the AM value and store for later
 	m_lfo_am = ((ampm & 0xff) * lfo_am_depth()) >> 7;
@@ -522,18 +566,24 @@ void ym2151::write(uint32_t offset, uint8_t data)
 
 void ym2151::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; OPM is full 14-bit with no intermediate clipping
+	m_fm.generate(output, numsamples, 0, 32767, fm_engine::ALL_CHANNELS);
+
+	// YM2151 uses an external DAC (YM3012) with mantissa/exponent format
+	// convert to 10.3 floating point value and back to simulate truncation
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->roundtrip_fp();
+}
 
-		// update the FM content; OPM is full 14-bit with no intermediate clipping
-		m_fm.output(output->clear(), 0, 32767, fm_engine::ALL_CHANNELS);
 
-		// YM2151 uses an external DAC (YM3012) with mantissa/exponent format
-		// convert to 10.3 floating point value and back to simulate truncation
-		output->roundtrip_fp();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2151::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 }
@@ -45,11 +45,36 @@ namespace ymfm
 template<bool IsOpnA>
 opn_registers_base<IsOpnA>::opn_registers_base() :
 	m_lfo_counter(0),
-	m_lfo_am(0)
+	m_lfo_am(0),
+	m_waveform(shared_tables().waveform)
+{
+}
+
+
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+template<bool IsOpnA>
+opn_registers_base<IsOpnA>::waveform_tables::waveform_tables()
 {
 	// create the waveforms
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+		waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+}
+
+
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+template<bool IsOpnA>
+typename opn_registers_base<IsOpnA>::waveform_tables const &opn_registers_base<IsOpnA>::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
 }
 
 
@@ -134,13 +159,16 @@ void opn_registers_base<true>::operator_map(operator_mapping &dest) const
 
 
 //-------------------------------------------------
-//  write - handle writes to the register array
+//  write - handle writes to the register array;
+//  modified is set to the mask of channels whose
+//  cached data may have changed as a result
 //-------------------------------------------------
 
 template<bool IsOpnA>
-bool opn_registers_base<IsOpnA>::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opn_registers_base<IsOpnA>::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
 	assert(index < REGISTERS);
+	modified = 0;
 
 	// writes in the 0xa0-af/0x1a0-af region are handled as latched pairs
 	// borrow unused registers 0xb8-bf/0x1b8-bf as temporary holding locations
@@ -160,8 +188,14 @@ bool opn_registers_base<IsOpnA>::write(uint16_t index, uint8_t data, uint32_t &c
 		// writes to the lower half only commit if the latch is there
 		else if (bitfield(m_regdata[latchindex], 7))
 		{
+			uint8_t upper = m_regdata[latchindex] & 0x3f;
+			if (m_regdata[index] != data || m_regdata[index | 4] != upper)
+			{
+				// A0-A3 are per-channel; A8-AB are the channel #2 multi-frequency values
+				modified = bitfield(index, 3) ? (1 << 2) : (1 << (bitfield(index, 0, 2) + 3 * bitfield(index, 8)));
+			}
 			m_regdata[index] = data;
-			m_regdata[index | 4] = m_regdata[latchindex] & 0x3f;
+			m_regdata[index | 4] = upper;
 			m_regdata[latchindex] = 0;
 		}
 		return false;
@@ -173,6 +207,23 @@ bool opn_registers_base<IsOpnA>::write(uint16_t index, uint8_t data, uint32_t &c
 	}
 
 	// everything else is normal
+	if (m_regdata[index] != data)
+	{
+		uint32_t reg = index & 0xff;
+
+		// per-channel and per-operator registers affect their channel, but
+		// channel index 3 in each bank is unused
+		if (reg >= 0x30 && bitfield(reg, 0, 2) != 3)
+			modified = 1 << (bitfield(reg, 0, 2) + 3 * bitfield(index, 8));
+
+		// the LFO enable determines whether phase steps are dynamic
+		else if (reg == 0x22)
+			modified = ALL_CHANNELS;
+
+		// the multi-frequency mode applies to channel #2
+		else if (reg == 0x27 && bitfield(m_regdata[index] ^ data, 6, 2) != 0)
+			modified = 1 << 2;
+	}
 	m_regdata[index] = data;
 
 	// handle writes to the key on index
@@ -467,16 +518,15 @@ void ssg_resampler<OutputType, FirstOutput, MixTo1>::add_last(int32_t &sum0, int
 
 
 //-------------------------------------------------
-//  clock_and_add - helper to clock a new value
-//  and then add it to the sums, applying the
-//  given scale
+//  clock_and_add - helper to take the next
+//  clocked value and then add it to the sums,
+//  applying the given scale
 //-------------------------------------------------
 
 template<typename OutputType, int FirstOutput, bool MixTo1>
 void ssg_resampler<OutputType, FirstOutput, MixTo1>::clock_and_add(int32_t &sum0, int32_t &sum1, int32_t &sum2, int32_t scale)
 {
-	m_ssg.clock();
-	m_ssg.output(m_last);
+	m_last = *m_next++;
 	add_last(sum0, sum1, sum2, scale);
 }
 
@@ -516,7 +566,10 @@ template<typename OutputType, int FirstOutput, bool MixTo1>
 ssg_resampler<OutputType, FirstOutput, MixTo1>::ssg_resampler(ssg_engine &ssg) :
 	m_ssg(ssg),
 	m_sampindex(0),
-	m_resampler(&ssg_resampler::resample_nop)
+	m_outsamples(0),
+	m_srcsamples(0),
+	m_resampler(&ssg_resampler::resample_nop),
+	m_next(nullptr)
 {
 	m_last.clear();
 }
@@ -541,6 +594,8 @@ void ssg_resampler<OutputType, FirstOutput, MixTo1>::save_restore(ymfm_saved_sta
 template<typename OutputType, int FirstOutput, bool MixTo1>
 void ssg_resampler<OutputType, FirstOutput, MixTo1>::configure(uint8_t outsamples, uint8_t srcsamples)
 {
+	m_outsamples = outsamples;
+	m_srcsamples = srcsamples;
 	switch (outsamples * 10 + srcsamples)
 	{
 		case 4*10 + 1:	/* 4:1 */	m_resampler = &ssg_resampler::resample_n_1<4>;	break;
@@ -570,15 +625,62 @@ void ssg_resampler<OutputType, FirstOutput, MixTo1>::resample_n_1(OutputType *ou
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
 		if (m_sampindex % Multiplier == 0)
-		{
-			m_ssg.clock();
-			m_ssg.output(m_last);
-		}
+			m_last = *m_next++;
 		write_to_output(output, m_last.data[0], m_last.data[1], m_last.data[2]);
 	}
 }
 
 
+//-------------------------------------------------
+//  resample - resample SSG output to the target
+//  at the configured ratio
+//-------------------------------------------------
+
+template<typename OutputType, int FirstOutput, bool MixTo1>
+void ssg_resampler<OutputType, FirstOutput, MixTo1>::resample(OutputType *output, uint32_t numsamples)
+{
+	// once a silent SSG has flushed its last output, only its counters need
+	// to be advanced
+	if (m_outsamples != 0 && (m_last.data[0] | m_last.data[1] | m_last.data[2]) == 0 && m_ssg.silent())
+		return resample_silent(output, numsamples);
+
+	// otherwise generate the SSG samples a block at a time, and let the
+	// resampler consume them
+	ssg_engine::output_data buffer[6 * BLOCK_SAMPLES];
+	while (numsamples != 0)
+	{
+		uint32_t const count = std::min<uint32_t>(numsamples, uint32_t(BLOCK_SAMPLES));
+		uint32_t const clocks = ssg_clocks(count);
+		m_ssg.generate(buffer, clocks);
+		m_next = buffer;
+		(this->*m_resampler)(output, count);
+		assert(m_next == &buffer[clocks]);
+		output += count;
+		numsamples -= count;
+	}
+}
+
+
+//-------------------------------------------------
+//  ssg_clocks - return the number of SSG clocks
+//  the configured resampler uses for the given
+//  number of output samples
+//-------------------------------------------------
+
+template<typename OutputType, int FirstOutput, bool MixTo1>
+uint32_t ssg_resampler<OutputType, FirstOutput, MixTo1>::ssg_clocks(uint32_t numsamples) const
+{
+	// every resampler has clocked the SSG ceil(n * src / out) times by the
+	// end of its nth output sample, in a pattern that repeats every out
+	// samples
+	if (m_outsamples == 0)
+		return 0;
+	uint64_t const start = m_sampindex % m_outsamples;
+	uint64_t const end = start + numsamples;
+	return uint32_t((end * m_srcsamples + m_outsamples - 1) / m_outsamples - (start * m_srcsamples + m_outsamples - 1) / m_outsamples);
+}
+
+
 //-------------------------------------------------
 //  resample_1_n - resample SSG output to the
 //  target at a rate of n SSG samples to every
@@ -672,6 +774,21 @@ void ssg_resampler<OutputType, FirstOutput, MixTo1>::resample_4_3(OutputType *ou
 }
 
 
+//-------------------------------------------------
+//  resample_silent - output zeros while a silent
+//  SSG is clocked as the configured resampler
+//  would
+//-------------------------------------------------
+
+template<typename OutputType, int FirstOutput, bool MixTo1>
+void ssg_resampler<OutputType, FirstOutput, MixTo1>::resample_silent(OutputType *output, uint32_t numsamples)
+{
+	m_ssg.advance(ssg_clocks(numsamples));
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+		write_to_output(output, 0, 0, 0);
+}
+
+
 //-------------------------------------------------
 //  resample_nop - no-op resampler
 //-------------------------------------------------
@@ -684,6 +801,67 @@ void ssg_resampler<OutputType, FirstOutput, MixTo1>::resample_nop(OutputType *ou
 }
 
 
+//-------------------------------------------------
+//  advance - advance the SSG as resample() would,
+//  discarding the output
+//-------------------------------------------------
+
+template<typename OutputType, int FirstOutput, bool MixTo1>
+void ssg_resampler<OutputType, FirstOutput, MixTo1>::advance(uint32_t numsamples)
+{
+	// only the last SSG output is needed, for the resampler to carry over
+	uint32_t const clocks = ssg_clocks(numsamples);
+	if (clocks != 0)
+	{
+		m_ssg.advance(clocks - 1);
+		m_ssg.clock();
+		m_ssg.output(m_last);
+	}
+	m_sampindex += numsamples;
+}
+
+
+//-------------------------------------------------
+//  generate_native - clock the SSG once per
+//  sample, outputting it at its native rate
+//-------------------------------------------------
+
+template<typename OutputType, int FirstOutput, bool MixTo1>
+void ssg_resampler<OutputType, FirstOutput, MixTo1>::generate_native(native_data *output, uint32_t numsamples)
+{
+	// an overridden SSG is output elsewhere
+	if (m_ssg.overridden())
+	{
+		for (uint32_t samp = 0; samp < numsamples; samp++)
+			output[samp].clear();
+		return;
+	}
+
+	ssg_engine::output_data buffer[BLOCK_SAMPLES];
+	while (numsamples != 0)
+	{
+		uint32_t const count = std::min<uint32_t>(numsamples, uint32_t(BLOCK_SAMPLES));
+		m_ssg.generate(buffer, count);
+		for (uint32_t samp = 0; samp < count; samp++, output++)
+		{
+			ssg_engine::output_data const &ssgout = buffer[samp];
+			if (MixTo1)
+			{
+				// mixing to one, apply the same 2/3 factor as write_to_output()
+				output->data[0] = (ssgout.data[0] + ssgout.data[1] + ssgout.data[2]) * 2 / 3;
+			}
+			else
+			{
+				for (int index = 0; index < NATIVE_OUTPUTS; index++)
+					output->data[index] = ssgout.data[index];
+			}
+		}
+		m_last = buffer[count - 1];
+		numsamples -= count;
+	}
+}
+
+
 
 //*********************************************************
 //  YM2203
@@ -857,35 +1035,138 @@ void ym2203::write(uint32_t offset, uint8_t data)
 
 void ym2203::generate(output_data *output, uint32_t numsamples)
 {
-	// FM output is just repeated the prescale number of times; note that
-	// 0 is a special 1.5 case
-	if (m_fm_samples_per_output != 0)
+	// FM output is just repeated the prescale number of times; the prescale
+	// can only change between calls, so pick the loop for it up front
+	switch (m_fm_samples_per_output)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-		{
-			if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
-				clock_fm();
-			output->data[0] = m_last_fm.data[0];
-		}
+		case 0:		generate_fm<0>(output, numsamples);		break;
+		case 1:		generate_fm<1>(output, numsamples);		break;
+		case 2:		generate_fm<2>(output, numsamples);		break;
+		case 3:		generate_fm<3>(output, numsamples);		break;
+		case 6:		generate_fm<6>(output, numsamples);		break;
+		case 9:		generate_fm<9>(output, numsamples);		break;
+		default:	generate_fm<18>(output, numsamples);	break;
 	}
-	else
+
+	// resample the SSG as configured
+	m_ssg_resampler.resample(output, numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm - generate the repeated FM output
+//  with the repeat count fixed at compile time;
+//  0 is a special 1.5 case
+//-------------------------------------------------
+
+template<uint32_t SamplesPerOutput>
+void ym2203::generate_fm(output_data *output, uint32_t numsamples)
+{
+	// the 1.5 case clocks twice every 3 samples, averaging the second
+	uint32_t const period = (SamplesPerOutput == 0) ? 3 : SamplesPerOutput;
+	uint32_t step = m_ssg_resampler.sampindex() % period;
+	while (numsamples != 0)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+		// count the samples whose FM clocks fit in a chunk
+		fm_engine::output_data fmout[2 * fm_engine::BLOCK_SAMPLES];
+		uint32_t count = 0;
+		uint32_t clocks = 0;
+		for (uint32_t index = step; count < numsamples; count++)
+		{
+			uint32_t needed = (index == 0 || (SamplesPerOutput == 0 && index == 1)) ? 1 : 0;
+			if (clocks + needed > array_size(fmout))
+				break;
+			clocks += needed;
+			if (++index == period)
+				index = 0;
+		}
+
+		// compute them all at once so the engine can work on them as a block;
+		// OPN is full 14-bit with no intermediate clipping, and each output
+		// is converted to 10.3 floating point value for the DAC and back
+		m_fm.generate(fmout, clocks, 0, 32767, fm_engine::ALL_CHANNELS);
+		for (uint32_t index = 0; index < clocks; index++)
+			fmout[index].roundtrip_fp();
+
+		// then hand them out the same way clock_fm() would
+		fm_engine::output_data const *next = fmout;
+		for (uint32_t samp = 0; samp < count; samp++, output++)
 		{
-			uint32_t step = (m_ssg_resampler.sampindex() + samp) % 3;
 			if (step == 0)
-				clock_fm();
+				m_last_fm = *next++;
 			output->data[0] = m_last_fm.data[0];
-			if (step == 1)
+			if (SamplesPerOutput == 0 && step == 1)
 			{
-				clock_fm();
+				m_last_fm = *next++;
 				output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
 			}
+			if (++step == period)
+				step = 0;
 		}
+		numsamples -= count;
 	}
+}
 
-	// resample the SSG as configured
-	m_ssg_resampler.resample(output - numsamples, numsamples);
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2203::advance(uint32_t numsamples)
+{
+	// count the FM clocks generate() would do; note that 0 is a special
+	// 1.5 case
+	uint32_t fmclocks = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		uint32_t index = m_ssg_resampler.sampindex() + samp;
+		if (m_fm_samples_per_output != 0)
+			fmclocks += (index % m_fm_samples_per_output == 0) ? 1 : 0;
+		else
+			fmclocks += (index % 3 != 2) ? 1 : 0;
+	}
+
+	// the last FM output is held over into the next generate(), so only
+	// that one needs to be computed
+	if (fmclocks != 0)
+	{
+		m_fm.advance(fmclocks - 1, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
+		clock_fm();
+	}
+
+	// advance the SSG as configured
+	m_ssg_resampler.advance(numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm_native - generate FM output at its
+//  native rate, one sample per FM clock
+//-------------------------------------------------
+
+void ym2203::generate_fm_native(fm_engine::output_data *output, uint32_t numsamples)
+{
+	// OPN is full 14-bit with no intermediate clipping, and each output is
+	// converted to 10.3 floating point value for the DAC and back
+	m_fm.generate(output, numsamples, 0, 32767, fm_engine::ALL_CHANNELS);
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+		output[samp].roundtrip_fp();
+
+	// keep the held value current in case generate() is used next
+	if (numsamples != 0)
+		m_last_fm = output[numsamples - 1];
+}
+
+
+//-------------------------------------------------
+//  generate_ssg_native - generate SSG output at
+//  its native rate
+//-------------------------------------------------
+
+void ym2203::generate_ssg_native(ssg_output_data *output, uint32_t numsamples)
+{
+	m_ssg_resampler.generate_native(output, numsamples);
 }
 
 
@@ -953,11 +1234,9 @@ void ym2203::update_prescale(uint8_t prescale)
 
 void ym2203::clock_fm()
 {
-	// clock the system
-	m_fm.clock(fm_engine::ALL_CHANNELS);
-
-	// update the FM content; OPN is full 14-bit with no intermediate clipping
-	m_fm.output(m_last_fm.clear(), 0, 32767, fm_engine::ALL_CHANNELS);
+	// clock the system and update the FM content; OPN is full 14-bit with
+	// no intermediate clipping
+	m_fm.generate(&m_last_fm, 1, 0, 32767, fm_engine::ALL_CHANNELS);
 
 	// convert to 10.3 floating point value for the DAC and back
 	m_last_fm.roundtrip_fp();
@@ -1292,38 +1571,109 @@ void ym2608::write(uint32_t offset, uint8_t data)
 
 void ym2608::generate(output_data *output, uint32_t numsamples)
 {
-	// FM output is just repeated the prescale number of times; note that
-	// 0 is a special 1.5 case
-	if (m_fm_samples_per_output != 0)
+	// FM output is just repeated the prescale number of times; the prescale
+	// can only change between calls, so pick the loop for it up front
+	switch (m_fm_samples_per_output)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-		{
-			if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
-				clock_fm_and_adpcm();
-			output->data[0] = m_last_fm.data[0];
-			output->data[1] = m_last_fm.data[1];
-		}
+		case 0:		generate_fm<0>(output, numsamples);		break;
+		case 1:		generate_fm<1>(output, numsamples);		break;
+		case 2:		generate_fm<2>(output, numsamples);		break;
+		case 3:		generate_fm<3>(output, numsamples);		break;
+		case 6:		generate_fm<6>(output, numsamples);		break;
+		case 9:		generate_fm<9>(output, numsamples);		break;
+		default:	generate_fm<18>(output, numsamples);	break;
 	}
-	else
+
+	// resample the SSG as configured
+	m_ssg_resampler.resample(output, numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm - generate the repeated FM output
+//  with the repeat count fixed at compile time;
+//  0 is a special 1.5 case
+//-------------------------------------------------
+
+template<uint32_t SamplesPerOutput>
+void ym2608::generate_fm(output_data *output, uint32_t numsamples)
+{
+	// the 1.5 case clocks twice every 3 samples, averaging the second
+	uint32_t const period = (SamplesPerOutput == 0) ? 3 : SamplesPerOutput;
+	uint32_t step = m_ssg_resampler.sampindex() % period;
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+		if (step == 0)
+			clock_fm_and_adpcm();
+		output->data[0] = m_last_fm.data[0];
+		output->data[1] = m_last_fm.data[1];
+		if (SamplesPerOutput == 0 && step == 1)
 		{
-			uint32_t step = (m_ssg_resampler.sampindex() + samp) % 3;
-			if (step == 0)
-				clock_fm_and_adpcm();
-			output->data[0] = m_last_fm.data[0];
-			output->data[1] = m_last_fm.data[1];
-			if (step == 1)
-			{
-				clock_fm_and_adpcm();
-				output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
-				output->data[1] = (output->data[1] + m_last_fm.data[1]) / 2;
-			}
+			clock_fm_and_adpcm();
+			output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
+			output->data[1] = (output->data[1] + m_last_fm.data[1]) / 2;
 		}
+		if (++step == period)
+			step = 0;
 	}
+}
 
-	// resample the SSG as configured
-	m_ssg_resampler.resample(output - numsamples, numsamples);
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2608::advance(uint32_t numsamples)
+{
+	// count the FM clocks generate() would do; note that 0 is a special
+	// 1.5 case
+	uint32_t fmclocks = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		uint32_t index = m_ssg_resampler.sampindex() + samp;
+		if (m_fm_samples_per_output != 0)
+			fmclocks += (index % m_fm_samples_per_output == 0) ? 1 : 0;
+		else
+			fmclocks += (index % 3 != 2) ? 1 : 0;
+	}
+
+	// the last FM output is held over into the next generate(), so only
+	// that one needs to be computed
+	for (uint32_t clock = 1; clock < fmclocks; clock++)
+		clock_fm_and_adpcm(false);
+	if (fmclocks != 0)
+		clock_fm_and_adpcm();
+
+	// advance the SSG as configured
+	m_ssg_resampler.advance(numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm_native - generate FM and ADPCM
+//  output at its native rate, one sample per FM
+//  clock
+//-------------------------------------------------
+
+void ym2608::generate_fm_native(fm_engine::output_data *output, uint32_t numsamples)
+{
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		clock_fm_and_adpcm();
+		output[samp] = m_last_fm;
+	}
+}
+
+
+//-------------------------------------------------
+//  generate_ssg_native - generate SSG output at
+//  its native rate
+//-------------------------------------------------
+
+void ym2608::generate_ssg_native(ssg_output_data *output, uint32_t numsamples)
+{
+	m_ssg_resampler.generate_native(output, numsamples);
 }
 
 
@@ -1386,10 +1736,11 @@ void ym2608::update_prescale(uint8_t prescale)
 
 
 //-------------------------------------------------
-//  clock_fm_and_adpcm - clock FM and ADPCM state
+//  clock_fm_and_adpcm - clock FM and ADPCM state,
+//  optionally skipping the output computation
 //-------------------------------------------------
 
-void ym2608::clock_fm_and_adpcm()
+void ym2608::clock_fm_and_adpcm(bool compute_output)
 {
 	// top bit of the IRQ enable flags controls 3-channel vs 6-channel mode
 	uint32_t fmmask = bitfield(m_irq_enable, 7) ? 0x3f : 0x07;
@@ -1405,6 +1756,13 @@ void ym2608::clock_fm_and_adpcm()
 	// clock the ADPCM-B engine every cycle
 	m_adpcm_b.clock();
 
+	// when advancing, only the FM feedback depends on the output
+	if (!compute_output)
+	{
+		m_fm.update_feedback(fmmask);
+		return;
+	}
+
 	// update the FM content; OPNA is 13-bit with no intermediate clipping
 	m_fm.output(m_last_fm.clear(), 1, 32767, fmmask);
 
@@ -1740,38 +2098,103 @@ void ymf288::write(uint32_t offset, uint8_t data)
 
 void ymf288::generate(output_data *output, uint32_t numsamples)
 {
-	// FM output is just repeated the prescale number of times; note that
-	// 0 is a special 1.5 case
-	if (m_fm_samples_per_output != 0)
+	// FM output is just repeated the prescale number of times, which is
+	// either 1 or 9 depending on the fidelity
+	if (m_fm_samples_per_output == 1)
+		generate_fm<1>(output, numsamples);
+	else
+		generate_fm<9>(output, numsamples);
+
+	// resample the SSG as configured
+	m_ssg_resampler.resample(output, numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm - generate the repeated FM output
+//  with the repeat count fixed at compile time;
+//  0 is a special 1.5 case
+//-------------------------------------------------
+
+template<uint32_t SamplesPerOutput>
+void ymf288::generate_fm(output_data *output, uint32_t numsamples)
+{
+	// the 1.5 case clocks twice every 3 samples, averaging the second
+	uint32_t const period = (SamplesPerOutput == 0) ? 3 : SamplesPerOutput;
+	uint32_t step = m_ssg_resampler.sampindex() % period;
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+		if (step == 0)
+			clock_fm_and_adpcm();
+		output->data[0] = m_last_fm.data[0];
+		output->data[1] = m_last_fm.data[1];
+		if (SamplesPerOutput == 0 && step == 1)
 		{
-			if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
-				clock_fm_and_adpcm();
-			output->data[0] = m_last_fm.data[0];
-			output->data[1] = m_last_fm.data[1];
+			clock_fm_and_adpcm();
+			output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
+			output->data[1] = (output->data[1] + m_last_fm.data[1]) / 2;
 		}
+		if (++step == period)
+			step = 0;
 	}
-	else
+}
+
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ymf288::advance(uint32_t numsamples)
+{
+	// count the FM clocks generate() would do; note that 0 is a special
+	// 1.5 case
+	uint32_t fmclocks = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
 	{
-		for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-		{
-			uint32_t step = (m_ssg_resampler.sampindex() + samp) % 3;
-			if (step == 0)
-				clock_fm_and_adpcm();
-			output->data[0] = m_last_fm.data[0];
-			output->data[1] = m_last_fm.data[1];
-			if (step == 1)
-			{
-				clock_fm_and_adpcm();
-				output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
-				output->data[1] = (output->data[1] + m_last_fm.data[1]) / 2;
-			}
-		}
+		uint32_t index = m_ssg_resampler.sampindex() + samp;
+		if (m_fm_samples_per_output != 0)
+			fmclocks += (index % m_fm_samples_per_output == 0) ? 1 : 0;
+		else
+			fmclocks += (index % 3 != 2) ? 1 : 0;
 	}
 
-	// resample the SSG as configured
-	m_ssg_resampler.resample(output - numsamples, numsamples);
+	// the last FM output is held over into the next generate(), so only
+	// that one needs to be computed
+	for (uint32_t clock = 1; clock < fmclocks; clock++)
+		clock_fm_and_adpcm(false);
+	if (fmclocks != 0)
+		clock_fm_and_adpcm();
+
+	// advance the SSG as configured
+	m_ssg_resampler.advance(numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm_native - generate FM and ADPCM
+//  output at its native rate, one sample per FM
+//  clock
+//-------------------------------------------------
+
+void ymf288::generate_fm_native(fm_engine::output_data *output, uint32_t numsamples)
+{
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		clock_fm_and_adpcm();
+		output[samp] = m_last_fm;
+	}
+}
+
+
+//-------------------------------------------------
+//  generate_ssg_native - generate SSG output at
+//  its native rate
+//-------------------------------------------------
+
+void ymf288::generate_ssg_native(ssg_output_data *output, uint32_t numsamples)
+{
+	m_ssg_resampler.generate_native(output, numsamples);
 }
 
 
@@ -1808,10 +2231,11 @@ void ymf288::update_prescale()
 
 
 //-------------------------------------------------
-//  clock_fm_and_adpcm - clock FM and ADPCM state
+//  clock_fm_and_adpcm - clock FM and ADPCM state,
+//  optionally skipping the output computation
 //-------------------------------------------------
 
-void ymf288::clock_fm_and_adpcm()
+void ymf288::clock_fm_and_adpcm(bool compute_output)
 {
 	// top bit of the IRQ enable flags controls 3-channel vs 6-channel mode
 	uint32_t fmmask = bitfield(m_irq_enable, 7) ? 0x3f : 0x07;
@@ -1824,6 +2248,13 @@ void ymf288::clock_fm_and_adpcm()
 	if (bitfield(env_counter, 0, 2) == 0)
 		m_adpcm_a.clock(bitfield(env_counter, 2) ? 0x0f : 0x3f);
 
+	// when advancing, only the FM feedback depends on the output
+	if (!compute_output)
+	{
+		m_fm.update_feedback(fmmask);
+		return;
+	}
+
 	// update the FM content; OPNA is 13-bit with no intermediate clipping
 	m_fm.output(m_last_fm.clear(), 1, 32767, fmmask);
 
@@ -2112,17 +2543,97 @@ void ym2610::write(uint32_t offset, uint8_t data)
 
 void ym2610::generate(output_data *output, uint32_t numsamples)
 {
-	// FM output is just repeated the prescale number of times
+	// FM output is just repeated the prescale number of times, which is
+	// either 1 or 9 depending on the fidelity
+	if (m_fm_samples_per_output == 1)
+		generate_fm<1>(output, numsamples);
+	else
+		generate_fm<9>(output, numsamples);
+
+	// resample the SSG as configured
+	m_ssg_resampler.resample(output, numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm - generate the repeated FM output
+//  with the repeat count fixed at compile time;
+//  0 is a special 1.5 case
+//-------------------------------------------------
+
+template<uint32_t SamplesPerOutput>
+void ym2610::generate_fm(output_data *output, uint32_t numsamples)
+{
+	// the 1.5 case clocks twice every 3 samples, averaging the second
+	uint32_t const period = (SamplesPerOutput == 0) ? 3 : SamplesPerOutput;
+	uint32_t step = m_ssg_resampler.sampindex() % period;
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
+		if (step == 0)
 			clock_fm_and_adpcm();
 		output->data[0] = m_last_fm.data[0];
 		output->data[1] = m_last_fm.data[1];
+		if (SamplesPerOutput == 0 && step == 1)
+		{
+			clock_fm_and_adpcm();
+			output->data[0] = (output->data[0] + m_last_fm.data[0]) / 2;
+			output->data[1] = (output->data[1] + m_last_fm.data[1]) / 2;
+		}
+		if (++step == period)
+			step = 0;
 	}
+}
 
-	// resample the SSG as configured
-	m_ssg_resampler.resample(output - numsamples, numsamples);
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2610::advance(uint32_t numsamples)
+{
+	// count the FM clocks generate() would do
+	uint32_t fmclocks = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+		if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
+			fmclocks++;
+
+	// the last FM output is held over into the next generate(), so only
+	// that one needs to be computed
+	for (uint32_t clock = 1; clock < fmclocks; clock++)
+		clock_fm_and_adpcm(false);
+	if (fmclocks != 0)
+		clock_fm_and_adpcm();
+
+	// advance the SSG as configured
+	m_ssg_resampler.advance(numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_fm_native - generate FM and ADPCM
+//  output at its native rate, one sample per FM
+//  clock
+//-------------------------------------------------
+
+void ym2610::generate_fm_native(fm_engine::output_data *output, uint32_t numsamples)
+{
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		clock_fm_and_adpcm();
+		output[samp] = m_last_fm;
+	}
+}
+
+
+//-------------------------------------------------
+//  generate_ssg_native - generate SSG output at
+//  its native rate
+//-------------------------------------------------
+
+void ym2610::generate_ssg_native(ssg_output_data *output, uint32_t numsamples)
+{
+	m_ssg_resampler.generate_native(output, numsamples);
 }
 
 
@@ -2159,10 +2670,11 @@ void ym2610::update_prescale()
 
 
 //-------------------------------------------------
-//  clock_fm_and_adpcm - clock FM and ADPCM state
+//  clock_fm_and_adpcm - clock FM and ADPCM state,
+//  optionally skipping the output computation
 //-------------------------------------------------
 
-void ym2610::clock_fm_and_adpcm()
+void ym2610::clock_fm_and_adpcm(bool compute_output)
 {
 	// clock the system
 	uint32_t env_counter = m_fm.clock(m_fm_mask);
@@ -2180,6 +2692,13 @@ void ym2610::clock_fm_and_adpcm()
 	if (((live_eos ^ m_eos_status) & 0x40) != 0)
 		m_eos_status = (m_eos_status & ~0xc0) | live_eos | (live_eos << 1);
 
+	// when advancing, only the FM feedback depends on the output
+	if (!compute_output)
+	{
+		m_fm.update_feedback(m_fm_mask);
+		return;
+	}
+
 	// update the FM content; OPNB is 13-bit with no intermediate clipping
 	m_fm.output(m_last_fm.clear(), 1, 32767, m_fm_mask);
 
@@ -2203,6 +2722,12 @@ ym2612::ym2612(ymfm_interface &intf) :
 	m_address(0),
 	m_dac_data(0),
 	m_dac_enable(0),
+	m_dac_stream_loop(0),
+	m_dac_stream_pos(0),
+	m_dac_stream_frac(0),
+	m_dac_stream_step(0),
+	m_dac_stream_length(0),
+	m_dac_stream(nullptr),
 	m_fm(intf)
 {
 }
@@ -2216,6 +2741,9 @@ void ym2612::reset()
 {
 	// reset the engines
 	m_fm.reset();
+
+	// stop any DAC stream
+	stop_dac_stream();
 }
 
 
@@ -2228,7 +2756,16 @@ void ym2612::save_restore(ymfm_saved_state &state)
 	state.save_restore(m_address);
 	state.save_restore(m_dac_data);
 	state.save_restore(m_dac_enable);
+	state.save_restore(m_dac_stream_loop);
+	state.save_restore(m_dac_stream_pos);
+	state.save_restore(m_dac_stream_frac);
+	state.save_restore(m_dac_stream_step);
+	state.save_restore(m_dac_stream_length);
 	m_fm.save_restore(state);
+
+	// the stream data belongs to the host, which must reattach it
+	if (!state.saving())
+		m_dac_stream = nullptr;
 }
 
 
@@ -2382,40 +2919,195 @@ void ym2612::write(uint32_t offset, uint8_t data)
 
 void ym2612::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	// split the request wherever the DAC stream supplies new data
+	while (numsamples != 0)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		uint32_t const count = dac_stream_samples(numsamples);
+		generate_run(output, count);
+		clock_dac_stream(count);
+		output += count;
+		numsamples -= count;
+	}
+}
 
-		// sum individual channels to apply DAC discontinuity on each
-		output->clear();
-		output_data temp;
 
-		// first do FM-only channels; OPN2 is 9-bit with intermediate clipping
-		int const last_fm_channel = m_dac_enable ? 5 : 6;
-		for (int chan = 0; chan < last_fm_channel; chan++)
-		{
-			m_fm.output(temp.clear(), 5, 256, 1 << chan);
-			output->data[0] += dac_discontinuity(temp.data[0]);
-			output->data[1] += dac_discontinuity(temp.data[1]);
-		}
+//-------------------------------------------------
+//  generate_run - generate samples over which the
+//  DAC data holds still
+//-------------------------------------------------
+
+void ym2612::generate_run(output_data *output, uint32_t numsamples)
+{
+	// the DAC can only be enabled or disabled between calls
+	if (m_dac_enable)
+		generate_channels<true>(output, numsamples);
+	else
+		generate_channels<false>(output, numsamples);
+}
+
+
+//-------------------------------------------------
+//  generate_channels - generate samples with the
+//  DAC state fixed at compile time
+//-------------------------------------------------
+
+template<bool DacEnable>
+void ym2612::generate_channels(output_data *output, uint32_t numsamples)
+{
+	// with the DAC enabled, the last channel is still clocked but not output
+	uint32_t const outmask = DacEnable ? (fm_engine::ALL_CHANNELS ^ (1 << 5)) : fm_engine::ALL_CHANNELS;
+	output_data const dacout = dac_output();
+	while (numsamples != 0)
+	{
+		// compute all the individual channels of a chunk of samples in one
+		// pass, then apply DAC discontinuity on each as they are mixed;
+		// OPN2 is 9-bit with intermediate clipping
+		output_data chanout[fm_engine::BLOCK_SAMPLES][fm_engine::CHANNELS];
+		uint32_t const count = std::min<uint32_t>(numsamples, uint32_t(fm_engine::BLOCK_SAMPLES));
+		m_fm.generate_channels(chanout[0], count, 5, 256, fm_engine::ALL_CHANNELS, outmask);
+		for (uint32_t samp = 0; samp < count; samp++, output++)
+			mix_channels<DacEnable>(*output, chanout[samp], dacout);
+		numsamples -= count;
+	}
+}
+
+
+//-------------------------------------------------
+//  dac_output - return the DAC contribution to
+//  each output, as mix_channels adds it
+//-------------------------------------------------
+
+ym2612::output_data ym2612::dac_output()
+{
+	output_data result;
+	int32_t dacval = dac_discontinuity(int16_t(m_dac_data << 7) >> 7);
+	result.data[0] = m_fm.regs().ch_output_0(0x102) ? dacval : dac_discontinuity(0);
+	result.data[1] = m_fm.regs().ch_output_1(0x102) ? dacval : dac_discontinuity(0);
+	return result;
+}
+
+
+//-------------------------------------------------
+//  mix_channels - mix the separately computed FM
+//  channel outputs together with the DAC
+//-------------------------------------------------
+
+template<bool DacEnable>
+void ym2612::mix_channels(output_data &output, output_data const *chanout, output_data const &dacout) const
+{
+	// first do FM-only channels
+	output.clear();
+	uint32_t const last_fm_channel = DacEnable ? 5 : 6;
+	for (uint32_t chan = 0; chan < last_fm_channel; chan++)
+	{
+		output.data[0] += dac_discontinuity(chanout[chan].data[0]);
+		output.data[1] += dac_discontinuity(chanout[chan].data[1]);
+	}
+
+	// DAC enabled: add the DAC value in place of the last channel
+	if (DacEnable)
+	{
+		output.data[0] += dacout.data[0];
+		output.data[1] += dacout.data[1];
+	}
+
+	// output is technically multiplexed rather than mixed, but that requires
+	// a better sound mixer than we usually have, so just average over the six
+	// channels; also apply a 64/65 factor to account for the discontinuity
+	// adjustment above
+	output.data[0] = (output.data[0] * 128) * 64 / (6 * 65);
+	output.data[1] = (output.data[1] * 128) * 64 / (6 * 65);
+}
+
+
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2612::advance(uint32_t numsamples)
+{
+	// with the DAC enabled, the last channel's output isn't computed; this
+	// also covers the YM3438 and YMF276, which differ only in their mixing
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_output_mask());
+	clock_dac_stream(numsamples);
+}
+
+
+//-------------------------------------------------
+//  start_dac_stream - begin streaming DAC data
+//  from memory
+//-------------------------------------------------
+
+void ym2612::start_dac_stream(uint8_t const *data, uint32_t length, uint32_t step, bool loop)
+{
+	m_dac_stream = (length != 0) ? data : nullptr;
+	m_dac_stream_length = length;
+	m_dac_stream_step = step;
+	m_dac_stream_loop = loop;
+	m_dac_stream_pos = 0;
+	m_dac_stream_frac = 0;
+
+	// the first byte is written immediately, as register 2A would be
+	if (m_dac_stream != nullptr)
+		m_dac_data = (m_dac_data & ~0x1fe) | ((data[0] ^ 0x80) << 1);
+}
+
+
+//-------------------------------------------------
+//  dac_stream_samples - return how many of the
+//  given samples pass before the DAC stream
+//  supplies new data
+//-------------------------------------------------
+
+uint32_t ym2612::dac_stream_samples(uint32_t numsamples) const
+{
+	if (m_dac_stream == nullptr || m_dac_stream_step == 0)
+		return numsamples;
+
+	// computed in 64 bits so that a step near 2^32 doesn't wrap; the
+	// fraction is below 0x10000, so this is always at least 1
+	uint64_t needed = (uint64_t(0x10000 - m_dac_stream_frac) + m_dac_stream_step - 1) / m_dac_stream_step;
+	return uint32_t(std::min<uint64_t>(numsamples, needed));
+}
+
+
+//-------------------------------------------------
+//  clock_dac_stream - advance the DAC stream by
+//  the given number of samples
+//-------------------------------------------------
+
+void ym2612::clock_dac_stream(uint32_t numsamples)
+{
+	if (m_dac_stream == nullptr)
+		return;
 
-		// add in DAC
-		if (m_dac_enable)
+	// nothing to do until the next byte; a value written to register 2A in
+	// the meantime holds until then
+	uint64_t pos = (uint64_t(m_dac_stream_pos) << 16) + m_dac_stream_frac + uint64_t(m_dac_stream_step) * numsamples;
+	if ((pos >> 16) == m_dac_stream_pos)
+	{
+		m_dac_stream_frac = uint32_t(pos & 0xffff);
+		return;
+	}
+
+	// advance the position; at the end either wrap or stop, leaving the
+	// last byte in the DAC
+	uint64_t const end = uint64_t(m_dac_stream_length) << 16;
+	if (pos >= end)
+	{
+		if (!m_dac_stream_loop)
 		{
-			// DAC enabled: start with DAC value then add the first 5 channels only
-			int32_t dacval = dac_discontinuity(int16_t(m_dac_data << 7) >> 7);
-			output->data[0] += m_fm.regs().ch_output_0(0x102) ? dacval : dac_discontinuity(0);
-			output->data[1] += m_fm.regs().ch_output_1(0x102) ? dacval : dac_discontinuity(0);
+			stop_dac_stream();
+			return;
 		}
-
-		// output is technically multiplexed rather than mixed, but that requires
-		// a better sound mixer than we usually have, so just average over the six
-		// channels; also apply a 64/65 factor to account for the discontinuity
-		// adjustment above
-		output->data[0] = (output->data[0] * 128) * 64 / (6 * 65);
-		output->data[1] = (output->data[1] * 128) * 64 / (6 * 65);
+		pos %= end;
 	}
+	m_dac_stream_pos = uint32_t(pos >> 16);
+	m_dac_stream_frac = uint32_t(pos & 0xffff);
+
+	// write the current byte as register 2A would
+	m_dac_data = (m_dac_data & ~0x1fe) | ((m_dac_stream[m_dac_stream_pos] ^ 0x80) << 1);
 }
 
 
@@ -2425,30 +3117,58 @@ void ym2612::generate(output_data *output, uint32_t numsamples)
 
 void ym3438::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	// split the request wherever the DAC stream supplies new data
+	while (numsamples != 0)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		uint32_t const count = dac_stream_samples(numsamples);
+		generate_run(output, count);
+		clock_dac_stream(count);
+		output += count;
+		numsamples -= count;
+	}
+}
 
-		// first do FM-only channels; OPN2C is 9-bit with intermediate clipping
-		if (!m_dac_enable)
-		{
-			// DAC disabled: all 6 channels sum together
-			m_fm.output(output->clear(), 5, 256, fm_engine::ALL_CHANNELS);
-		}
-		else
+
+//-------------------------------------------------
+//  generate_run - generate samples over which the
+//  DAC data holds still
+//-------------------------------------------------
+
+void ym3438::generate_run(output_data *output, uint32_t numsamples)
+{
+	// first do FM-only channels; OPN2C is 9-bit with intermediate clipping
+	if (!m_dac_enable)
+	{
+		// DAC disabled: all 6 channels sum together
+		m_fm.generate(output, numsamples, 5, 256, fm_engine::ALL_CHANNELS);
+	}
+	else
+	{
+		// DAC enabled: the last channel is still clocked, but only the first 5
+		// are output
+		for (uint32_t samp = 0; samp < numsamples; samp++)
 		{
-			// DAC enabled: start with DAC value then add the first 5 channels only
-			int32_t dacval = int16_t(m_dac_data << 7) >> 7;
-			output->data[0] = m_fm.regs().ch_output_0(0x102) ? dacval : 0;
-			output->data[1] = m_fm.regs().ch_output_1(0x102) ? dacval : 0;
-			m_fm.output(*output, 5, 256, fm_engine::ALL_CHANNELS ^ (1 << 5));
+			m_fm.clock(fm_engine::ALL_CHANNELS);
+			m_fm.output(output[samp].clear(), 5, 256, fm_engine::ALL_CHANNELS ^ (1 << 5));
 		}
+	}
 
-		// YM3438 doesn't have the same DAC discontinuity, though its output is
-		// multiplexed like the YM2612
-		output->data[0] = (output->data[0] * 128) / 6;
-		output->data[1] = (output->data[1] * 128) / 6;
+	// DAC enabled: add in the DAC value
+	output_data dacout;
+	dacout.clear();
+	if (m_dac_enable)
+	{
+		int32_t dacval = int16_t(m_dac_data << 7) >> 7;
+		dacout.data[0] = m_fm.regs().ch_output_0(0x102) ? dacval : 0;
+		dacout.data[1] = m_fm.regs().ch_output_1(0x102) ? dacval : 0;
+	}
+
+	// YM3438 doesn't have the same DAC discontinuity, though its output is
+	// multiplexed like the YM2612
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	{
+		output->data[0] = ((output->data[0] + dacout.data[0]) * 128) / 6;
+		output->data[1] = ((output->data[1] + dacout.data[1]) * 128) / 6;
 	}
 }
 
@@ -2459,29 +3179,57 @@ void ym3438::generate(output_data *output, uint32_t numsamples)
 
 void ymf276::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	// split the request wherever the DAC stream supplies new data
+	while (numsamples != 0)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		uint32_t const count = dac_stream_samples(numsamples);
+		generate_run(output, count);
+		clock_dac_stream(count);
+		output += count;
+		numsamples -= count;
+	}
+}
 
-		// first do FM-only channels; OPN2L is 14-bit with intermediate clipping
-		if (!m_dac_enable)
-		{
-			// DAC disabled: all 6 channels sum together
-			m_fm.output(output->clear(), 0, 8191, fm_engine::ALL_CHANNELS);
-		}
-		else
+
+//-------------------------------------------------
+//  generate_run - generate samples over which the
+//  DAC data holds still
+//-------------------------------------------------
+
+void ymf276::generate_run(output_data *output, uint32_t numsamples)
+{
+	// first do FM-only channels; OPN2L is 14-bit with intermediate clipping
+	if (!m_dac_enable)
+	{
+		// DAC disabled: all 6 channels sum together
+		m_fm.generate(output, numsamples, 0, 8191, fm_engine::ALL_CHANNELS);
+	}
+	else
+	{
+		// DAC enabled: the last channel is still clocked, but only the first 5
+		// are output
+		for (uint32_t samp = 0; samp < numsamples; samp++)
 		{
-			// DAC enabled: start with DAC value then add the first 5 channels only
-			int32_t dacval = int16_t(m_dac_data << 7) >> 7;
-			output->data[0] = m_fm.regs().ch_output_0(0x102) ? dacval : 0;
-			output->data[1] = m_fm.regs().ch_output_1(0x102) ? dacval : 0;
-			m_fm.output(*output, 0, 8191, fm_engine::ALL_CHANNELS ^ (1 << 5));
+			m_fm.clock(fm_engine::ALL_CHANNELS);
+			m_fm.output(output[samp].clear(), 0, 8191, fm_engine::ALL_CHANNELS ^ (1 << 5));
 		}
+	}
+
+	// DAC enabled: add in the DAC value
+	output_data dacout;
+	dacout.clear();
+	if (m_dac_enable)
+	{
+		int32_t dacval = int16_t(m_dac_data << 7) >> 7;
+		dacout.data[0] = m_fm.regs().ch_output_0(0x102) ? dacval : 0;
+		dacout.data[1] = m_fm.regs().ch_output_1(0x102) ? dacval : 0;
+	}
 
-		// YMF276 is properly mixed; it shifts down 1 bit before clamping
-		output->data[0] = clamp(output->data[0] >> 1, -32768, 32767);
-		output->data[1] = clamp(output->data[1] >> 1, -32768, 32767);
+	// YMF276 is properly mixed; it shifts down 1 bit before clamping
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	{
+		output->data[0] = clamp((output->data[0] + dacout.data[0]) >> 1, -32768, 32767);
+		output->data[1] = clamp((output->data[1] + dacout.data[1]) >> 1, -32768, 32767);
 	}
 }
 
@@ -165,8 +165,8 @@ public:
 	// read a register value
 	uint8_t read(uint16_t index) const { return m_regdata[index]; }
 
-	// handle writes to the register array
-	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask);
+	// handle writes to the register array, noting which channels' cached data changed
+	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask, uint32_t &modified);
 
 	// clock the noise and LFO, if present, returning LFO PM value
 	int32_t clock_noise_and_lfo();
@@ -244,11 +244,19 @@ protected:
 		return (byte(offset1, start1, count1, extra_offset) << count2) | byte(offset2, start2, count2, extra_offset);
 	}
 
+	// tables shared by all instances, built on first use
+	struct waveform_tables
+	{
+		waveform_tables();
+		uint16_t waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	};
+	static waveform_tables const &shared_tables();
+
 	// internal state
 	uint32_t m_lfo_counter;               // LFO counter
 	uint8_t m_lfo_am;                     // current LFO AM value
 	uint8_t m_regdata[REGISTERS];         // register data
-	uint16_t m_waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	uint16_t const (*m_waveform)[WAVEFORM_LENGTH]; // waveforms (shared)
 };
 
 using opn_registers = opn_registers_base<false>;
@@ -344,10 +352,17 @@ template<typename OutputType, int FirstOutput, bool MixTo1>
 class ssg_resampler
 {
 private:
+	// maximum number of output samples resampled from one block of SSG samples
+	static constexpr uint32_t BLOCK_SAMPLES = 32;
+
+	// return the number of SSG clocks the configured resampler uses for the
+	// given number of output samples
+	uint32_t ssg_clocks(uint32_t numsamples) const;
+
 	// helper to add the last computed value to the sums, applying the given scale
 	void add_last(int32_t &sum0, int32_t &sum1, int32_t &sum2, int32_t scale = 1);
 
-	// helper to clock a new value and then add it to the sums, applying the given scale
+	// helper to take the next clocked value and then add it to the sums, applying the given scale
 	void clock_and_add(int32_t &sum0, int32_t &sum1, int32_t &sum2, int32_t scale = 1);
 
 	// helper to write the sums to the appropriate outputs, applying the given
@@ -355,6 +370,10 @@ private:
 	void write_to_output(OutputType *output, int32_t sum0, int32_t sum1, int32_t sum2, int32_t divisor = 1);
 
 public:
+	// output of the SSG alone at its native rate, mixed as for the target
+	static constexpr int NATIVE_OUTPUTS = MixTo1 ? 1 : ssg_engine::OUTPUTS;
+	using native_data = ymfm_output<NATIVE_OUTPUTS>;
+
 	// constructor
 	ssg_resampler(ssg_engine &ssg);
 
@@ -368,10 +387,13 @@ public:
 	void configure(uint8_t outsamples, uint8_t srcsamples);
 
 	// resample
-	void resample(OutputType *output, uint32_t numsamples)
-	{
-		(this->*m_resampler)(output, numsamples);
-	}
+	void resample(OutputType *output, uint32_t numsamples);
+
+	// advance as resample() would, discarding the output
+	void advance(uint32_t numsamples);
+
+	// clock the SSG once per sample, outputting it at its native rate
+	void generate_native(native_data *output, uint32_t numsamples);
 
 private:
 	// resample SSG output to the target at a rate of 1 SSG sample
@@ -400,6 +422,10 @@ private:
 	// to every 4 output samples
 	void resample_4_3(OutputType *output, uint32_t numsamples);
 
+	// output zeros while a silent SSG is clocked as the configured
+	// resampler would
+	void resample_silent(OutputType *output, uint32_t numsamples);
+
 	// no-op resampler
 	void resample_nop(OutputType *output, uint32_t numsamples);
 
@@ -409,8 +435,11 @@ private:
 	// internal state
 	ssg_engine &m_ssg;
 	uint32_t m_sampindex;
+	uint8_t m_outsamples;
+	uint8_t m_srcsamples;
 	resample_func m_resampler;
 	ssg_engine::output_data m_last;
+	ssg_engine::output_data const *m_next;
 };
 
 
@@ -465,11 +494,29 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// alternatively, generate the FM and SSG as two separate streams, each at
+	// its native rate; both must be brought to the same time before any write
+	using ssg_output_data = ymfm_output<SSG_OUTPUTS>;
+	uint32_t fm_sample_rate(uint32_t input_clock) const { return m_fm.sample_rate(input_clock); }
+	uint32_t ssg_sample_rate(uint32_t input_clock) const { return ssg_effective_clock(input_clock) / 8; }
+	void generate_fm_native(fm_engine::output_data *output, uint32_t numsamples);
+	void generate_ssg_native(ssg_output_data *output, uint32_t numsamples);
+
+	// direct access to the SSG, for rendering it with ssg_blep
+	ssg_engine &ssg() { return m_ssg; }
+
 protected:
 	// internal helpers
 	void update_prescale(uint8_t prescale);
 	void clock_fm();
 
+	// generate the repeated FM output with the repeat count fixed at compile time
+	template<uint32_t SamplesPerOutput>
+	void generate_fm(output_data *output, uint32_t numsamples);
+
 	// internal state
 	opn_fidelity m_fidelity;            // configured fidelity
 	uint8_t m_address;                  // address register
@@ -546,10 +593,28 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// alternatively, generate the FM and SSG as two separate streams, each at
+	// its native rate; both must be brought to the same time before any write
+	using ssg_output_data = ymfm_output<SSG_OUTPUTS>;
+	uint32_t fm_sample_rate(uint32_t input_clock) const { return m_fm.sample_rate(input_clock); }
+	uint32_t ssg_sample_rate(uint32_t input_clock) const { return ssg_effective_clock(input_clock) / 8; }
+	void generate_fm_native(fm_engine::output_data *output, uint32_t numsamples);
+	void generate_ssg_native(ssg_output_data *output, uint32_t numsamples);
+
+	// direct access to the SSG, for rendering it with ssg_blep
+	ssg_engine &ssg() { return m_ssg; }
+
 protected:
 	// internal helpers
 	void update_prescale(uint8_t prescale);
-	void clock_fm_and_adpcm();
+	void clock_fm_and_adpcm(bool compute_output = true);
+
+	// generate the repeated FM output with the repeat count fixed at compile time
+	template<uint32_t SamplesPerOutput>
+	void generate_fm(output_data *output, uint32_t numsamples);
 
 	// internal state
 	opn_fidelity m_fidelity;            // configured fidelity
@@ -620,11 +685,29 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// alternatively, generate the FM and SSG as two separate streams, each at
+	// its native rate; both must be brought to the same time before any write
+	using ssg_output_data = ymfm_output<SSG_OUTPUTS>;
+	uint32_t fm_sample_rate(uint32_t input_clock) const { return m_fm.sample_rate(input_clock); }
+	uint32_t ssg_sample_rate(uint32_t input_clock) const { return ssg_effective_clock(input_clock) / 8; }
+	void generate_fm_native(fm_engine::output_data *output, uint32_t numsamples);
+	void generate_ssg_native(ssg_output_data *output, uint32_t numsamples);
+
+	// direct access to the SSG, for rendering it with ssg_blep
+	ssg_engine &ssg() { return m_ssg; }
+
 protected:
 	// internal helpers
 	bool ymf288_mode() { return ((m_fm.regs().read(0x20) & 0x02) != 0); }
 	void update_prescale();
-	void clock_fm_and_adpcm();
+	void clock_fm_and_adpcm(bool compute_output = true);
+
+	// generate the repeated FM output with the repeat count fixed at compile time
+	template<uint32_t SamplesPerOutput>
+	void generate_fm(output_data *output, uint32_t numsamples);
 
 	// internal state
 	opn_fidelity m_fidelity;            // configured fidelity
@@ -697,10 +780,28 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// alternatively, generate the FM and SSG as two separate streams, each at
+	// its native rate; both must be brought to the same time before any write
+	using ssg_output_data = ymfm_output<SSG_OUTPUTS>;
+	uint32_t fm_sample_rate(uint32_t input_clock) const { return m_fm.sample_rate(input_clock); }
+	uint32_t ssg_sample_rate(uint32_t input_clock) const { return ssg_effective_clock(input_clock) / 8; }
+	void generate_fm_native(fm_engine::output_data *output, uint32_t numsamples);
+	void generate_ssg_native(ssg_output_data *output, uint32_t numsamples);
+
+	// direct access to the SSG, for rendering it with ssg_blep
+	ssg_engine &ssg() { return m_ssg; }
+
 protected:
 	// internal helpers
 	void update_prescale();
-	void clock_fm_and_adpcm();
+	void clock_fm_and_adpcm(bool compute_output = true);
+
+	// generate the repeated FM output with the repeat count fixed at compile time
+	template<uint32_t SamplesPerOutput>
+	void generate_fm(output_data *output, uint32_t numsamples);
 
 	// internal state
 	opn_fidelity m_fidelity;            // configured fidelity
@@ -761,14 +862,64 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
+	// stream 8-bit DAC data (as written to register 2A) from memory; the
+	// 16.16 step is the number of bytes consumed per output sample, and the
+	// data must remain valid until the stream ends or is stopped, or until it
+	// is replaced with set_dac_stream_data()
+	void start_dac_stream(uint8_t const *data, uint32_t length, uint32_t step, bool loop = false);
+	void stop_dac_stream() { m_dac_stream = nullptr; m_dac_stream_length = 0; }
+	bool dac_stream_active() const { return (m_dac_stream != nullptr); }
+
+	// change the 16.16 step of the stream in progress
+	void set_dac_stream_step(uint32_t step) { m_dac_stream_step = step; }
+
+	// point the stream in progress at another copy of its data, keeping its
+	// position; the saved state doesn't include the data pointer, so after a
+	// restore a stream that was in progress holds still, and is inactive,
+	// until the host supplies its data again this way
+	void set_dac_stream_data(uint8_t const *data) { if (m_dac_stream_length != 0) m_dac_stream = data; }
+
 protected:
+	// generate samples over which the DAC data holds still
+	void generate_run(output_data *output, uint32_t numsamples);
+
+	// return how many of the given samples pass before the DAC stream
+	// supplies new data
+	uint32_t dac_stream_samples(uint32_t numsamples) const;
+
+	// advance the DAC stream by the given number of samples
+	void clock_dac_stream(uint32_t numsamples);
+
 	// simulate the DAC discontinuity
 	constexpr int32_t dac_discontinuity(int32_t value) const { return (value < 0) ? (value - 3) : (value + 4); }
 
+	// return the FM channels that are output, given the DAC state
+	uint32_t fm_output_mask() const { return m_dac_enable ? (fm_engine::ALL_CHANNELS ^ (1 << 5)) : fm_engine::ALL_CHANNELS; }
+
+	// generate samples with the DAC state fixed at compile time
+	template<bool DacEnable>
+	void generate_channels(output_data *output, uint32_t numsamples);
+
+	// return the DAC contribution to each output, as mix_channels adds it
+	output_data dac_output();
+
+	// mix the separately computed FM channel outputs and the DAC
+	template<bool DacEnable>
+	void mix_channels(output_data &output, output_data const *chanout, output_data const &dacout) const;
+
 	// internal state
 	uint16_t m_address;              // address register
 	uint16_t m_dac_data;             // 9-bit DAC data
 	uint8_t m_dac_enable;            // DAC enabled?
+	uint8_t m_dac_stream_loop;       // DAC stream loops at the end?
+	uint32_t m_dac_stream_pos;       // DAC stream byte position
+	uint32_t m_dac_stream_frac;      // DAC stream fractional position
+	uint32_t m_dac_stream_step;      // DAC stream 16.16 step per sample
+	uint32_t m_dac_stream_length;    // DAC stream length in bytes
+	uint8_t const *m_dac_stream;     // DAC stream data, or nullptr if stopped or detached
 	fm_engine m_fm;                  // core FM engine
 };
 
@@ -782,6 +933,10 @@ public:
 
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
+
+protected:
+	// generate samples over which the DAC data holds still
+	void generate_run(output_data *output, uint32_t numsamples);
 };
 
 
@@ -794,6 +949,10 @@ public:
 
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples);
+
+protected:
+	// generate samples over which the DAC data holds still
+	void generate_run(output_data *output, uint32_t numsamples);
 };
 
 }
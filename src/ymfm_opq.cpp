@@ -57,15 +57,38 @@ namespace ymfm
 
 opq_registers::opq_registers() :
 	m_lfo_counter(0),
-	m_lfo_am(0)
+	m_lfo_am(0),
+	m_waveform(shared_tables().waveform)
+{
+}
+
+
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+opq_registers::waveform_tables::waveform_tables()
 {
 	// create the waveforms
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+		waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
 
-	uint16_t zeroval = m_waveform[0][0];
+	uint16_t zeroval = waveform[0][0];
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[1][index] = bitfield(index, 9) ? zeroval : m_waveform[0][index];
+		waveform[1][index] = bitfield(index, 9) ? zeroval : waveform[0][index];
+}
+
+
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+opq_registers::waveform_tables const &opq_registers::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
 }
 
 
@@ -119,18 +142,31 @@ void opq_registers::operator_map(operator_mapping &dest) const
 
 
 //-------------------------------------------------
-//  write - handle writes to the register array
+//  write - handle writes to the register array;
+//  modified is set to the mask of channels whose
+//  cached data may have changed as a result
 //-------------------------------------------------
 
-bool opq_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opq_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
 	assert(index < REGISTERS);
+	modified = 0;
 
 	// detune/multiple share a register based on the MSB of what is written
 	// remap the multiple values to 100-11F
 	if ((index & 0xe0) == 0x40 && bitfield(data, 7) != 0)
 		index += 0xc0;
 
+	if (m_regdata[index] != data)
+	{
+		// per-channel and per-operator registers affect their channel
+		if (index >= 0x10)
+			modified = 1 << bitfield(index, 0, 3);
+
+		// the LFO enable determines whether phase steps are dynamic
+		else if (index == 0x04)
+			modified = ALL_CHANNELS;
+	}
 	m_regdata[index] = data;
 
 	// handle writes to the key on index
@@ -463,18 +499,24 @@ if (TEMPORARY_DEBUG_PRINTS && (offset != 3 || data != 0x71)) printf("Write %02X
 
 void ym3806::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; YM3806 is full 14-bit with no intermediate clipping
+	m_fm.generate(output, numsamples, 0, 32767, fm_engine::ALL_CHANNELS);
+
+	// YM3608 appears to go through a YM3012 DAC, which means we want to apply
+	// the FP truncation logic to the outputs
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->roundtrip_fp();
+}
 
-		// update the FM content; YM3806 is full 14-bit with no intermediate clipping
-		m_fm.output(output->clear(), 0, 32767, fm_engine::ALL_CHANNELS);
 
-		// YM3608 appears to go through a YM3012 DAC, which means we want to apply
-		// the FP truncation logic to the outputs
-		output->roundtrip_fp();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym3806::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 }
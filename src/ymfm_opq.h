@@ -147,8 +147,8 @@ public:
 	struct operator_mapping { uint32_t chan[CHANNELS]; };
 	void operator_map(operator_mapping &dest) const;
 
-	// handle writes to the register array
-	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask);
+	// handle writes to the register array, noting which channels' cached data changed
+	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask, uint32_t &modified);
 
 	// clock the noise and LFO, if present, returning LFO PM value
 	int32_t clock_noise_and_lfo();
@@ -224,11 +224,19 @@ protected:
 		return (byte(offset1, start1, count1, extra_offset) << count2) | byte(offset2, start2, count2, extra_offset);
 	}
 
+	// tables shared by all instances, built on first use
+	struct waveform_tables
+	{
+		waveform_tables();
+		uint16_t waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	};
+	static waveform_tables const &shared_tables();
+
 	// internal state
 	uint32_t m_lfo_counter;               // LFO counter
 	uint8_t m_lfo_am;                     // current LFO AM value
 	uint8_t m_regdata[REGISTERS];         // register data
-	uint16_t m_waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	uint16_t const (*m_waveform)[WAVEFORM_LENGTH]; // waveforms (shared)
 };
 
 
@@ -271,6 +279,9 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// advance the state as generate() would, without computing any output
+	void advance(uint32_t numsamples);
+
 protected:
 	// internal state
 	fm_engine m_fm;                  // core FM engine
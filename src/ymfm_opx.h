@@ -131,8 +131,8 @@ public:
 	struct operator_mapping { uint32_t chan[CHANNELS]; };
 	void operator_map(operator_mapping &dest) const;
 
-	// handle writes to the register array
-	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask);
+	// handle writes to the register array, noting which channels' cached data changed
+	bool write(uint16_t index, uint8_t data, uint32_t &chan, uint32_t &opmask, uint32_t &modified);
 
 	// clock the noise and LFO, if present, returning LFO PM value
 	int32_t clock_noise_and_lfo();
@@ -225,6 +225,15 @@ protected:
 		return (byte(offset1, start1, count1, extra_offset) << count2) | byte(offset2, start2, count2, extra_offset);
 	}
 
+	// tables shared by all instances, built on first use
+	struct waveform_tables
+	{
+		waveform_tables();
+		uint16_t waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+		int16_t lfo_waveform[3][LFO_WAVEFORM_LENGTH]; // fixed LFO waveforms; AM in low 8, PM in upper 8
+	};
+	static waveform_tables const &shared_tables();
+
 	// internal state
 	uint32_t m_lfo_counter[2];            // LFO counter
 	uint32_t m_noise_lfsr;                // noise LFSR state
@@ -234,8 +243,9 @@ protected:
 	uint8_t m_lfo_am[2];                  // current LFO AM value
 	uint8_t m_regdata[REGISTERS];         // register data
 	uint16_t m_phase_substep[OPERATORS];  // phase substep for fixed frequency
-	int16_t m_lfo_waveform[4][LFO_WAVEFORM_LENGTH]; // LFO waveforms; AM in low 8, PM in upper 8
-	uint16_t m_waveform[WAVEFORMS][WAVEFORM_LENGTH]; // waveforms
+	int16_t const (*m_lfo_waveform)[LFO_WAVEFORM_LENGTH]; // fixed LFO waveforms 0-2 (shared); AM in low 8, PM in upper 8
+	int16_t m_lfo_noise[LFO_WAVEFORM_LENGTH]; // LFO noise waveform, filled in dynamically
+	uint16_t const (*m_waveform)[WAVEFORM_LENGTH]; // waveforms (shared)
 };
 
 
@@ -98,29 +98,43 @@ opz_registers::opz_registers() :
 	m_noise_counter(0),
 	m_noise_state(0),
 	m_noise_lfo(0),
-	m_lfo_am{ 0, 0 }
+	m_lfo_am{ 0, 0 },
+	m_lfo_waveform(shared_tables().lfo_waveform),
+	m_waveform(shared_tables().waveform)
+{
+	// LFO waveform 3 is noise and is filled in dynamically
+	std::fill_n(&m_lfo_noise[0], LFO_WAVEFORM_LENGTH, 0);
+}
+
+
+//-------------------------------------------------
+//  waveform_tables - constructor; builds the
+//  tables shared by all instances
+//-------------------------------------------------
+
+opz_registers::waveform_tables::waveform_tables()
 {
 	// create the waveforms
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
+		waveform[0][index] = abs_sin_attenuation(index) | (bitfield(index, 9) << 15);
 
 	// we only have the diagrams to judge from, but suspecting waveform 1 (and
 	// derived waveforms) are sin^2, based on OPX description of similar wave-
 	// forms; since our sin table is logarithmic, this ends up just being
 	// 2*existing value
-	uint16_t zeroval = m_waveform[0][0];
+	uint16_t zeroval = waveform[0][0];
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
-		m_waveform[1][index] = std::min<uint16_t>(2 * (m_waveform[0][index] & 0x7fff), zeroval) | (bitfield(index, 9) << 15);
+		waveform[1][index] = std::min<uint16_t>(2 * (waveform[0][index] & 0x7fff), zeroval) | (bitfield(index, 9) << 15);
 
 	// remaining waveforms are just derivations of the 2 main ones
 	for (uint32_t index = 0; index < WAVEFORM_LENGTH; index++)
 	{
-		m_waveform[2][index] = bitfield(index, 9) ? zeroval : m_waveform[0][index];
-		m_waveform[3][index] = bitfield(index, 9) ? zeroval : m_waveform[1][index];
-		m_waveform[4][index] = bitfield(index, 9) ? zeroval : m_waveform[0][index * 2];
-		m_waveform[5][index] = bitfield(index, 9) ? zeroval : m_waveform[1][index * 2];
-		m_waveform[6][index] = bitfield(index, 9) ? zeroval : m_waveform[0][(index * 2) & 0x1ff];
-		m_waveform[7][index] = bitfield(index, 9) ? zeroval : m_waveform[1][(index * 2) & 0x1ff];
+		waveform[2][index] = bitfield(index, 9) ? zeroval : waveform[0][index];
+		waveform[3][index] = bitfield(index, 9) ? zeroval : waveform[1][index];
+		waveform[4][index] = bitfield(index, 9) ? zeroval : waveform[0][index * 2];
+		waveform[5][index] = bitfield(index, 9) ? zeroval : waveform[1][index * 2];
+		waveform[6][index] = bitfield(index, 9) ? zeroval : waveform[0][(index * 2) & 0x1ff];
+		waveform[7][index] = bitfield(index, 9) ? zeroval : waveform[1][(index * 2) & 0x1ff];
 	}
 
 	// create the LFO waveforms; AM in the low 8 bits, PM in the upper 8
@@ -130,23 +144,33 @@ opz_registers::opz_registers() :
 		// waveform 0 is a sawtooth
 		uint8_t am = index ^ 0xff;
 		int8_t pm = int8_t(index);
-		m_lfo_waveform[0][index] = am | (pm << 8);
+		lfo_waveform[0][index] = am | (pm << 8);
 
 		// waveform 1 is a square wave
 		am = bitfield(index, 7) ? 0 : 0xff;
 		pm = int8_t(am ^ 0x80);
-		m_lfo_waveform[1][index] = am | (pm << 8);
+		lfo_waveform[1][index] = am | (pm << 8);
 
 		// waveform 2 is a triangle wave
 		am = bitfield(index, 7) ? (index << 1) : ((index ^ 0xff) << 1);
 		pm = int8_t(bitfield(index, 6) ? am : ~am);
-		m_lfo_waveform[2][index] = am | (pm << 8);
-
-		// waveform 3 is noise; it is filled in dynamically
+		lfo_waveform[2][index] = am | (pm << 8);
 	}
 }
 
 
+//-------------------------------------------------
+//  shared_tables - return the shared tables,
+//  building them on first use
+//-------------------------------------------------
+
+opz_registers::waveform_tables const &opz_registers::shared_tables()
+{
+	static waveform_tables const s_tables;
+	return s_tables;
+}
+
+
 //-------------------------------------------------
 //  reset - reset to initial state
 //-------------------------------------------------
@@ -208,12 +232,15 @@ void opz_registers::operator_map(operator_mapping &dest) const
 
 
 //-------------------------------------------------
-//  write - handle writes to the register array
+//  write - handle writes to the register array;
+//  modified is set to the mask of channels whose
+//  cached data may have changed as a result
 //-------------------------------------------------
 
-bool opz_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask)
+bool opz_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint32_t &opmask, uint32_t &modified)
 {
 	assert(index < REGISTERS);
+	modified = 0;
 
 	// special mappings:
 	//   0x16 -> 0x188 if bit 7 is set
@@ -221,18 +248,23 @@ bool opz_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint3
 	//   0x38..0x3F -> 0x180..0x187 if bit 7 is set
 	//   0x40..0x5F -> 0x100..0x11F if bit 7 is set
 	//   0xC0..0xDF -> 0x120..0x13F if bit 5 is set
+	uint32_t target = index;
 	if (index == 0x17 && bitfield(data, 7) != 0)
-		m_regdata[0x188] = data;
+		target = 0x188;
 	else if (index == 0x19 && bitfield(data, 7) != 0)
-		m_regdata[0x189] = data;
+		target = 0x189;
 	else if ((index & 0xf8) == 0x38 && bitfield(data, 7) != 0)
-		m_regdata[0x180 + (index & 7)] = data;
+		target = 0x180 + (index & 7);
 	else if ((index & 0xe0) == 0x40 && bitfield(data, 7) != 0)
-		m_regdata[0x100 + (index & 0x1f)] = data;
+		target = 0x100 + (index & 0x1f);
 	else if ((index & 0xe0) == 0xc0 && bitfield(data, 5) != 0)
-		m_regdata[0x120 + (index & 0x1f)] = data;
-	else if (index < 0x100)
-		m_regdata[index] = data;
+		target = 0x120 + (index & 0x1f);
+	if (target < 0x100 || target != index)
+	{
+		if (m_regdata[target] != data)
+			modified = modified_channels(target, data);
+		m_regdata[target] = data;
+	}
 
 	// preset writes restore some values from a preset memory; not sure
 	// how this really works but the TX81Z will overwrite the sustain level/
@@ -251,6 +283,7 @@ bool opz_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint3
 		m_regdata[0x120 + chan + 8] = m_regdata[0x160 + chan + 8];
 		m_regdata[0x120 + chan + 16] = m_regdata[0x160 + chan + 16];
 		m_regdata[0x120 + chan + 24] = m_regdata[0x160 + chan + 24];
+		modified |= 1 << chan;
 	}
 
 	// store the presets under some unknown condition; the pattern of writes
@@ -300,6 +333,31 @@ bool opz_registers::write(uint16_t index, uint8_t data, uint32_t &channel, uint3
 }
 
 
+//-------------------------------------------------
+//  modified_channels - return the mask of channels
+//  whose cached data depends on the given (mapped)
+//  register, which is about to change to the given
+//  value
+//-------------------------------------------------
+
+uint32_t opz_registers::modified_channels(uint16_t target, uint8_t data) const
+{
+	// per-channel and per-operator registers, including the remapped
+	// ones, affect their channel
+	if (target < 0x08 || (target >= 0x20 && target < 0x188))
+		return 1 << bitfield(target, 0, 3);
+
+	// PM depths determine whether phase steps are dynamic
+	if (target == 0x188 || target == 0x189)
+		return ALL_CHANNELS;
+
+	// noise enable changes how channel 7 is generated
+	if (target == 0x0f && bitfield(m_regdata[target] ^ data, 7) != 0)
+		return 1 << 7;
+	return 0;
+}
+
+
 //-------------------------------------------------
 //  clock_noise_and_lfo - clock the noise and LFO,
 //  handling clock division, depth, and waveform
@@ -342,14 +400,16 @@ int32_t opz_registers::clock_noise_and_lfo()
 	// ensures the current value remains stable for a full LFO clock
 	// and effectively latches the running value when the LFO advances
 	uint32_t lfo_noise = bitfield(m_noise_lfsr, 17, 8);
-	m_lfo_waveform[3][(lfo0 + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
-	m_lfo_waveform[3][(lfo1 + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
+	m_lfo_noise[(lfo0 + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
+	m_lfo_noise[(lfo1 + 1) & 0xff] = lfo_noise | (lfo_noise << 8);
 
 	// fetch the AM/PM values based on the waveform; AM is unsigned and
 	// encoded in the low 8 bits, while PM signed and encoded in the upper
-	// 8 bits
-	int32_t ampm0 = m_lfo_waveform[lfo_waveform()][lfo0];
-	int32_t ampm1 = m_lfo_waveform[lfo2_waveform()][lfo1];
+	// 8 bits; waveform 3 is the noise
+	uint32_t waveform0 = lfo_waveform();
+	uint32_t waveform1 = lfo2_waveform();
+	int32_t ampm0 = (waveform0 == 3) ? m_lfo_noise[lfo0] : m_lfo_waveform[waveform0][lfo0];
+	int32_t ampm1 = (waveform1 == 3) ? m_lfo_noise[lfo1] : m_lfo_waveform[waveform1][lfo1];
 
 	// apply depth to the AM values and store for later
 	m_lfo_am[0] = ((ampm0 & 0xff) * lfo_am_depth()) >> 7;
@@ -792,17 +852,23 @@ void ym2414::write(uint32_t offset, uint8_t data)
 
 void ym2414::generate(output_data *output, uint32_t numsamples)
 {
+	// generate the FM content; YM2414 is full 14-bit with no intermediate clipping
+	m_fm.generate(output, numsamples, 0, 32767, fm_engine::ALL_CHANNELS);
+
+	// unsure about YM2414 outputs; assume it is like YM2151
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
+		output->roundtrip_fp();
+}
 
-		// update the FM content; YM2414 is full 14-bit with no intermediate clipping
-		m_fm.output(output->clear(), 0, 32767, fm_engine::ALL_CHANNELS);
 
-		// unsure about YM2414 outputs; assume it is like YM2151
-		output->roundtrip_fp();
-	}
+//-------------------------------------------------
+//  advance - advance the state by the given
+//  number of samples without computing any output
+//-------------------------------------------------
+
+void ym2414::advance(uint32_t numsamples)
+{
+	m_fm.advance(numsamples, fm_engine::ALL_CHANNELS, fm_engine::ALL_CHANNELS);
 }
 
 }
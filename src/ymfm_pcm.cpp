@@ -446,7 +446,7 @@ void pcm_channel::load_wavetable()
 
 uint8_t pcm_channel::read_pcm(uint32_t address) const
 {
-	return m_owner.intf().ymfm_external_read(ACCESS_PCM, address);
+	return m_owner.intf().ymfm_external_read_mapped(ACCESS_PCM, address);
 }
 
 
@@ -586,7 +586,7 @@ pcm_engine::pcm_engine(ymfm_interface &intf) :
 {
 	// create the channels
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum] = std::make_unique<pcm_channel>(*this, chnum);
+		m_channel.construct(chnum, *this, chnum);
 }
 
 
@@ -601,7 +601,7 @@ void pcm_engine::reset()
 
 	// reset each channel
 	for (auto &chan : m_channel)
-		chan->reset();
+		chan.reset();
 }
 
 
@@ -616,7 +616,7 @@ void pcm_engine::save_restore(ymfm_saved_state &state)
 
 	// save channel state
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
-		m_channel[chnum]->save_restore(state);
+		m_channel[chnum].save_restore(state);
 }
 
 
@@ -634,7 +634,7 @@ void pcm_engine::clock(uint32_t chanmask)
 		m_active_channels = 0;
 		for (int chnum = 0; chnum < CHANNELS; chnum++)
 			if (bitfield(chanmask, chnum))
-				if (m_channel[chnum]->prepare())
+				if (m_channel[chnum].prepare())
 					m_active_channels |= 1 << chnum;
 
 		// reset the modified channels and prepare count
@@ -650,7 +650,7 @@ void pcm_engine::clock(uint32_t chanmask)
 	// now update the state of all the channels and operators
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			m_channel[chnum]->clock(m_env_counter >> 1);
+			m_channel[chnum].clock(m_env_counter >> 1);
 }
 
 
@@ -666,7 +666,7 @@ void pcm_engine::output(output_data &output, uint32_t chanmask)
 	// compute the output of each channel
 	for (int chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			m_channel[chnum]->output(output);
+			m_channel[chnum].output(output);
 }
 
 
@@ -678,7 +678,7 @@ uint8_t pcm_engine::read(uint32_t regnum)
 {
 	// handle reads from the data register
 	if (regnum == 0x06 && m_regs.memory_access_mode() != 0)
-		return m_intf.ymfm_external_read(ACCESS_PCM, m_regs.memory_address_autoinc());
+		return m_intf.ymfm_external_read_mapped(ACCESS_PCM, m_regs.memory_address_autoinc());
 
 	return m_regs.read(regnum);
 }
@@ -705,11 +705,11 @@ void pcm_engine::write(uint32_t regnum, uint8_t data)
 
 	// however, process keyons immediately
 	if (regnum >= 0x68 && regnum <= 0x7f)
-		m_channel[regnum - 0x68]->keyonoff(bitfield(data, 7));
+		m_channel[regnum - 0x68].keyonoff(bitfield(data, 7));
 
 	// and also wavetable writes
 	else if (regnum >= 0x08 && regnum <= 0x1f)
-		m_channel[regnum - 0x08]->load_wavetable();
+		m_channel[regnum - 0x08].load_wavetable();
 }
 
 }
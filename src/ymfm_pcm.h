@@ -338,7 +338,7 @@ private:
 	uint32_t m_modified_channels;                     // bitmask of modified channels
 	uint32_t m_active_channels;                       // bitmask of active channels
 	uint32_t m_prepare_count;                         // counter to do periodic prepare sweeps
-	std::unique_ptr<pcm_channel> m_channel[CHANNELS]; // array of channels
+	ymfm_inline_array<pcm_channel, CHANNELS> m_channel; // array of channels
 	pcm_registers m_regs;                             // registers
 };
 
@@ -29,6 +29,9 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ymfm_ssg.h"
+#include <cmath>
+#include <complex>
+#include <vector>
 
 namespace ymfm
 {
@@ -62,6 +65,43 @@ void ssg_registers::save_restore(ymfm_saved_state &state)
 // SSG ENGINE
 //*********************************************************
 
+//-------------------------------------------------
+//  clocks_to_reset - return the number of clocks
+//  until a counter that is incremented each clock
+//  reaches the given period and resets
+//-------------------------------------------------
+
+inline uint32_t clocks_to_reset(uint32_t counter, uint32_t period)
+{
+	// a counter already past the period resets on the next clock
+	return (counter + 1 >= period) ? 1 : (period - counter);
+}
+
+
+//-------------------------------------------------
+//  advance_counter - advance a counter that is
+//  incremented each clock and reset after
+//  reaching the given period; returns the number
+//  of times it was reset
+//-------------------------------------------------
+
+inline uint32_t advance_counter(uint32_t &counter, uint32_t period, uint32_t clocks)
+{
+	// the first reset happens when the counter reaches the period
+	uint32_t first = clocks_to_reset(counter, period);
+	if (clocks < first)
+	{
+		counter += clocks;
+		return 0;
+	}
+
+	// after that, it resets every period clocks
+	uint32_t remaining = clocks - first;
+	counter = remaining % period;
+	return 1 + remaining / period;
+}
+
+
 //-------------------------------------------------
 //  ssg_engine - constructor
 //-------------------------------------------------
@@ -230,6 +270,112 @@ void ssg_engine::output(output_data &output)
 }
 
 
+//-------------------------------------------------
+//  generate - clock and compute outputs for the
+//  given number of samples, holding the output
+//  over the clocks where no generator changes it
+//-------------------------------------------------
+
+void ssg_engine::generate(output_data *output, uint32_t numsamples)
+{
+	while (numsamples != 0)
+	{
+		// clock and compute a sample normally
+		clock();
+		ssg_engine::output(*output);
+		output_data const &last = *output++;
+		numsamples--;
+
+		// then repeat it until the next clock that could change it
+		uint32_t count = std::min(numsamples, steady_clocks());
+		advance(count);
+		for (numsamples -= count; count != 0; count--)
+			*output++ = last;
+	}
+}
+
+
+//-------------------------------------------------
+//  silent - return true if the output is zero
+//  regardless of the tone, noise and envelope
+//-------------------------------------------------
+
+bool ssg_engine::silent() const
+{
+	// only channels at a fixed amplitude of 0 are guaranteed to be silent
+	for (int chan = 0; chan < 3; chan++)
+		if (m_regs.ch_envelope_enable(chan) != 0 || m_regs.ch_amplitude(chan) != 0)
+			return false;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  steady_clocks - return how many upcoming
+//  clocks leave the output unchanged
+//-------------------------------------------------
+
+uint32_t ssg_engine::steady_clocks() const
+{
+	// only generators feeding an audible channel matter
+	uint32_t result = ~0;
+	uint32_t noise_used = 0;
+	uint32_t envelope_used = 0;
+	for (int chan = 0; chan < 3; chan++)
+	{
+		if (m_regs.ch_envelope_enable(chan) == 0 && m_regs.ch_amplitude(chan) == 0)
+			continue;
+		envelope_used |= m_regs.ch_envelope_enable(chan);
+		noise_used |= m_regs.ch_noise_enable_n(chan) ^ 1;
+		if (m_regs.ch_tone_enable_n(chan) == 0)
+			result = std::min(result, clocks_to_reset(m_tone_count[chan], tone_period(chan)));
+	}
+	if (noise_used != 0)
+		result = std::min(result, clocks_to_reset(m_noise_count, noise_period()));
+
+	// the envelope no longer matters once it is held at the end
+	if (envelope_used != 0 && !((m_regs.envelope_hold() | (m_regs.envelope_continue() ^ 1)) && m_envelope_state >= 32))
+		result = std::min(result, clocks_to_reset(m_envelope_count, envelope_period()));
+
+	// the clock that resets a counter may change the output
+	return result - 1;
+}
+
+
+//-------------------------------------------------
+//  advance - advance the tone, noise and envelope
+//  state as the given number of clock() and
+//  output() calls would, without computing any
+//  output
+//-------------------------------------------------
+
+void ssg_engine::advance(uint32_t count)
+{
+	if (count == 0)
+		return;
+
+	// clock tones
+	for (int chan = 0; chan < 3; chan++)
+		m_tone_state[chan] ^= advance_counter(m_tone_count[chan], tone_period(chan), count) & 1;
+
+	// clock noise; the 17-bit LFSR feeds back bits 0 and 3, so up to 14
+	// steps can be computed from the current state at once
+	uint32_t steps = advance_counter(m_noise_count, noise_period(), count);
+	while (steps != 0)
+	{
+		uint32_t const batch = std::min<uint32_t>(steps, 14);
+		uint32_t const feedback = (m_noise_state ^ (m_noise_state >> 3)) & ((1 << batch) - 1);
+		m_noise_state = (m_noise_state >> batch) | (feedback << (17 - batch));
+		steps -= batch;
+	}
+
+	// clock envelope, then clamp it as output() would
+	m_envelope_state += advance_counter(m_envelope_count, envelope_period(), count);
+	if ((m_regs.envelope_hold() | (m_regs.envelope_continue() ^ 1)) && m_envelope_state >= 32)
+		m_envelope_state = 32;
+}
+
+
 //-------------------------------------------------
 //  read - handle reads from the SSG registers
 //-------------------------------------------------
@@ -276,4 +422,228 @@ void ssg_engine::write(uint32_t regnum, uint8_t data)
 		m_intf.ymfm_external_write(ACCESS_IO, 1, data);
 }
 
+
+
+//*********************************************************
+// SSG BLEP
+//*********************************************************
+
+//-------------------------------------------------
+//  blep_dft - compute a discrete Fourier transform
+//  in place; this is only done once while building
+//  the step table, so it needn't be an FFT
+//-------------------------------------------------
+
+inline void blep_dft(std::vector<std::complex<double>> &data, bool inverse)
+{
+	uint32_t const size = data.size();
+	double const angle = (inverse ? 2.0 : -2.0) * std::acos(-1.0) / size;
+	std::vector<std::complex<double>> twiddle(size);
+	for (uint32_t index = 0; index < size; index++)
+		twiddle[index] = std::polar(1.0, angle * index);
+
+	std::vector<std::complex<double>> result(size);
+	for (uint32_t freq = 0; freq < size; freq++)
+	{
+		std::complex<double> sum = 0;
+		for (uint32_t index = 0; index < size; index++)
+			sum += data[index] * twiddle[(uint64_t(freq) * index) % size];
+		result[freq] = inverse ? (sum / double(size)) : sum;
+	}
+	data = result;
+}
+
+
+//-------------------------------------------------
+//  blep_residual - return the minimum phase
+//  band-limited step minus an ideal step, at
+//  OVERSAMPLE points per output sample, as 2.14
+//  fixed point values
+//-------------------------------------------------
+
+inline int16_t const *blep_residual()
+{
+	static std::vector<int16_t> const s_residual = []()
+	{
+		uint32_t const size = ssg_blep::TAPS * ssg_blep::OVERSAMPLE + 1;
+		double const pi = std::acos(-1.0);
+
+		// start from a Blackman-windowed sinc spanning all the taps
+		std::vector<std::complex<double>> data(size);
+		for (uint32_t index = 0; index < size; index++)
+		{
+			double x = pi * (double(index) - (size - 1) / 2.0) / ssg_blep::OVERSAMPLE;
+			double window = 0.42 - 0.5 * std::cos(2 * pi * index / (size - 1)) + 0.08 * std::cos(4 * pi * index / (size - 1));
+			data[index] = ((x == 0) ? 1.0 : (std::sin(x) / x)) * window;
+		}
+
+		// take the real cepstrum, and fold it onto the causal half
+		blep_dft(data, false);
+		for (auto &value : data)
+			value = std::log(std::max(std::abs(value), 1e-100));
+		blep_dft(data, true);
+		for (uint32_t index = 1; index < size; index++)
+			data[index] = (index <= size / 2) ? (2.0 * data[index].real()) : 0.0;
+		data[0] = data[0].real();
+
+		// back out the minimum phase impulse
+		blep_dft(data, false);
+		for (auto &value : data)
+			value = std::exp(value);
+		blep_dft(data, true);
+
+		// integrate it into a step, normalized to end at 1
+		std::vector<double> step(size);
+		double sum = 0;
+		for (uint32_t index = 0; index < size; index++)
+			step[index] = (sum += data[index].real());
+
+		std::vector<int16_t> result(size);
+		for (uint32_t index = 0; index < size; index++)
+			result[index] = int16_t(std::lround((step[index] / sum - 1.0) * (1 << ssg_blep::RESIDUAL_SHIFT)));
+		return result;
+	}();
+	return s_residual.data();
+}
+
+
+//-------------------------------------------------
+//  ssg_blep - constructor
+//-------------------------------------------------
+
+ssg_blep::ssg_blep(ssg_engine &ssg, uint32_t ssg_rate, uint32_t output_rate) :
+	m_ssg(ssg),
+	m_step(0),
+	m_phase(0),
+	m_steady(0),
+	m_index(0),
+	m_level{ 0 },
+	m_residual{ { 0 } }
+{
+	configure(ssg_rate, output_rate);
+}
+
+
+//-------------------------------------------------
+//  configure - configure the SSG's native rate
+//  and the output rate
+//-------------------------------------------------
+
+void ssg_blep::configure(uint32_t ssg_rate, uint32_t output_rate)
+{
+	m_step = (uint64_t(ssg_rate) << 32) / output_rate;
+}
+
+
+//-------------------------------------------------
+//  reset - reset our state
+//-------------------------------------------------
+
+void ssg_blep::reset()
+{
+	m_phase = 0;
+	m_steady = 0;
+	m_index = 0;
+	for (int chan = 0; chan < OUTPUTS; chan++)
+	{
+		m_level[chan] = 0;
+		std::fill_n(&m_residual[chan][0], TAPS, 0);
+	}
+}
+
+
+//-------------------------------------------------
+//  save_restore - save or restore the data; the
+//  rates are configuration and the steady count
+//  is recomputed by generate(), so neither is
+//  saved
+//-------------------------------------------------
+
+void ssg_blep::save_restore(ymfm_saved_state &state)
+{
+	state.save_restore(m_phase);
+	state.save_restore(m_index);
+	state.save_restore(m_level);
+	state.save_restore(m_residual);
+}
+
+
+//-------------------------------------------------
+//  generate - clock the SSG through the given
+//  number of output samples, rendering its
+//  channels at the output rate
+//-------------------------------------------------
+
+void ssg_blep::generate(output_data *output, uint32_t numsamples)
+{
+	// an overridden SSG is output elsewhere
+	if (m_ssg.overridden())
+	{
+		for (uint32_t samp = 0; samp < numsamples; samp++)
+			output[samp].clear();
+		return;
+	}
+
+	// the registers may have changed since the last call
+	m_steady = 0;
+	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	{
+		// run the SSG clocks that fall within this output sample
+		uint64_t const end = m_phase + m_step;
+		uint32_t const clocks = uint32_t(end >> 32);
+		for (uint32_t clock = 1; clock <= clocks; )
+		{
+			// skip over clocks that can't change the output
+			if (m_steady != 0)
+			{
+				uint32_t const count = std::min(m_steady, clocks + 1 - clock);
+				m_ssg.advance(count);
+				m_steady -= count;
+				clock += count;
+				continue;
+			}
+
+			// clock and compute the output, placing a step in each channel
+			// that changed at how far before the output sample it happened
+			output_data ssgout;
+			m_ssg.clock();
+			m_ssg.output(ssgout);
+			uint32_t const position = uint32_t(((end - (uint64_t(clock) << 32)) * OVERSAMPLE + m_step / 2) / m_step);
+			for (int chan = 0; chan < OUTPUTS; chan++)
+				if (ssgout.data[chan] != m_level[chan])
+				{
+					add_step(chan, ssgout.data[chan] - m_level[chan], position);
+					m_level[chan] = ssgout.data[chan];
+				}
+			m_steady = m_ssg.steady_clocks();
+			clock++;
+		}
+		m_phase = uint32_t(end);
+
+		// output the levels with the pending residuals of recent steps
+		for (int chan = 0; chan < OUTPUTS; chan++)
+		{
+			output->data[chan] = m_level[chan] + ((m_residual[chan][m_index] + (1 << (RESIDUAL_SHIFT - 1))) >> RESIDUAL_SHIFT);
+			m_residual[chan][m_index] = 0;
+		}
+		m_index = (m_index + 1) % TAPS;
+	}
+}
+
+
+//-------------------------------------------------
+//  add_step - add a band-limited step to a
+//  channel, where position is how far past the
+//  step the current output sample falls, in
+//  OVERSAMPLE units
+//-------------------------------------------------
+
+void ssg_blep::add_step(int chan, int32_t delta, uint32_t position)
+{
+	int16_t const *residual = blep_residual() + position;
+	int32_t *dest = m_residual[chan];
+	for (uint32_t tap = 0; tap < TAPS; tap++)
+		dest[(m_index + tap) % TAPS] += delta * residual[tap * OVERSAMPLE];
+}
+
 }
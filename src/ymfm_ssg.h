@@ -171,6 +171,20 @@ public:
 	// compute sum of channel outputs
 	void output(output_data &output);
 
+	// clock and compute outputs for the given number of samples, holding the
+	// output over the clocks where no generator changes it
+	void generate(output_data *output, uint32_t numsamples);
+
+	// true if the output is zero regardless of the tone, noise and envelope
+	bool silent() const;
+
+	// return how many upcoming clocks leave the output unchanged
+	uint32_t steady_clocks() const;
+
+	// advance the tone, noise and envelope state as the given number of
+	// clock() and output() calls would, without computing any output
+	void advance(uint32_t count);
+
 	// read/write to the SSG registers
 	uint8_t read(uint32_t regnum);
 	void write(uint32_t regnum, uint8_t data);
@@ -188,6 +202,12 @@ public:
 	void prescale_changed() { if (m_override != nullptr) m_override->ssg_prescale_changed(); }
 
 private:
+	// effective periods of the generator counters; the tone and envelope
+	// treat 0 as 1, and noise is compared at twice its period
+	uint32_t tone_period(int chan) const { return std::max<uint32_t>(m_regs.ch_tone_period(chan), 1); }
+	uint32_t noise_period() const { return std::max<uint32_t>(m_regs.noise_period() * 2, 2); }
+	uint32_t envelope_period() const { return std::max<uint32_t>(m_regs.envelope_period(), 1); }
+
 	// internal state
 	ymfm_interface &m_intf;                   // reference to the interface
 	uint32_t m_tone_count[3];               // current tone counter
@@ -200,6 +220,60 @@ private:
 	ssg_override *m_override;               // override interface
 };
 
+
+
+// ======================> ssg_blep
+
+// renders an SSG's output directly at an arbitrary host sample rate; rather
+// than resampling the SSG's native output, each change in a channel's level
+// is placed at its exact time as a band-limited (minimum phase) step, which
+// avoids aliasing with a latency of only a few samples
+class ssg_blep
+{
+public:
+	static constexpr int OUTPUTS = ssg_engine::OUTPUTS;
+	using output_data = ssg_engine::output_data;
+
+	// number of output samples each step is spread over
+	static constexpr uint32_t TAPS = 16;
+
+	// number of sub-sample positions a step can be placed at
+	static constexpr uint32_t OVERSAMPLE = 32;
+
+	// number of fractional bits in the step residuals
+	static constexpr uint32_t RESIDUAL_SHIFT = 14;
+
+	// constructor
+	ssg_blep(ssg_engine &ssg, uint32_t ssg_rate, uint32_t output_rate);
+
+	// configure the SSG's native rate (one sample per clock) and the output
+	// rate; call again if the SSG's rate changes
+	void configure(uint32_t ssg_rate, uint32_t output_rate);
+
+	// reset our state; call along with resetting the SSG
+	void reset();
+
+	// save/restore; call along with saving or restoring the SSG
+	void save_restore(ymfm_saved_state &state);
+
+	// clock the SSG through the given number of output samples, rendering
+	// its channels at the output rate
+	void generate(output_data *output, uint32_t numsamples);
+
+private:
+	// add a band-limited step to a channel at the given sub-sample position
+	void add_step(int chan, int32_t delta, uint32_t position);
+
+	// internal state
+	ssg_engine &m_ssg;                  // SSG engine
+	uint64_t m_step;                    // 32.32 SSG clocks per output sample
+	uint32_t m_phase;                   // fraction of an SSG clock already elapsed
+	uint32_t m_steady;                  // SSG clocks known to leave the output unchanged
+	uint32_t m_index;                   // current position in the residual buffer
+	int32_t m_level[OUTPUTS];           // current level of each channel
+	int32_t m_residual[OUTPUTS][TAPS];  // pending step residuals per channel (x.14)
+};
+
 }
 
 #endif // YMFM_SSG_H